@@ -0,0 +1,49 @@
+#include <iostream>
+#include <queue>
+
+#include "compact_priority_queue.hpp"
+
+int rand() {
+	static unsigned reed = 1727417277;
+	return (reed = reed * 1103515245u + 12345u) >> 1;
+}
+
+// pushes, pops and merges of random sizes against std::priority_queue
+bool testMerge()
+{
+	sjtu::compact_priority_queue<int> q;
+	std::priority_queue<int> ref;
+	for (int round = 0; round < 300; round++) {
+		sjtu::compact_priority_queue<int> other;
+		for (int i = rand() % 2000; i > 0; i--) {
+			int x = rand() % 100000;
+			other.push(x);
+			ref.push(x);
+		}
+		if (rand() % 2) q.merge(other);
+		else {
+			other.merge(q);
+			q.swap(other);
+		}
+		if (!other.empty() || q.size() != ref.size()) return false;
+		for (int i = rand() % 1000; i > 0 && !ref.empty(); i--) {
+			if (q.top() != ref.top()) return false;
+			if (rand() % 2) q.pop();
+			else if (q.pop_value() != ref.top()) return false;
+			ref.pop();
+		}
+	}
+	sjtu::compact_priority_queue<int> copy(q);
+	while (!ref.empty()) {
+		if (copy.top() != ref.top()) return false;
+		copy.pop();
+		ref.pop();
+	}
+	return copy.empty() && !q.empty();
+}
+
+int main()
+{
+	std::cout << (testMerge() ? "OKAY" : "FAIL") << std::endl;
+	return 0;
+}
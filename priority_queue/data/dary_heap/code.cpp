@@ -0,0 +1,75 @@
+#include <algorithm>
+#include <iostream>
+#include <queue>
+#include <vector>
+
+#include "dary_heap.hpp"
+
+int rand() {
+	static unsigned reed = 1727417277;
+	return (reed = reed * 1103515245u + 12345u) >> 1;
+}
+
+// push, pop, pop_value and replace_top against std::priority_queue
+template<int D>
+bool testRandom()
+{
+	sjtu::dary_heap<int, std::less<int>, D> h;
+	std::priority_queue<int> ref;
+	for (int i = 0; i < 200000; i++) {
+		int op = rand() % 6;
+		if (op < 3 || ref.empty()) {
+			int x = rand() % 100000;
+			h.push(x);
+			ref.push(x);
+		} else if (op == 3) {
+			h.pop();
+			ref.pop();
+		} else if (op == 4) {
+			if (h.pop_value() != ref.top()) return false;
+			ref.pop();
+		} else {
+			int x = rand() % 100000;
+			h.replace_top(x);
+			ref.pop();
+			ref.push(x);
+		}
+		if (h.size() != ref.size()) return false;
+		if (!ref.empty() && h.top() != ref.top()) return false;
+	}
+	sjtu::dary_heap<int, std::less<int>, D> copy(h);
+	while (!ref.empty()) {
+		if (copy.top() != ref.top()) return false;
+		copy.pop();
+		ref.pop();
+	}
+	return copy.empty() && !h.empty();
+}
+
+// the range constructor heapifies and pop_n yields the largest first
+bool testBuildPopN()
+{
+	std::vector<int> a;
+	for (int i = 0; i < 10000; i++) a.push_back(rand() % 1000);
+	sjtu::dary_heap<int> h(a.begin(), a.end());
+	std::sort(a.begin(), a.end(), std::greater<int>());
+	std::vector<int> out;
+	if (h.pop_n(100, out) != 100) return false;
+	if (h.pop_n(20000, out) != 9900) return false;
+	if (out != a || !h.empty()) return false;
+	try {
+		h.pop();
+	} catch (...) {
+		return true;
+	}
+	return false;
+}
+
+int main()
+{
+	std::cout << (testRandom<2>() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (testRandom<4>() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (testRandom<8>() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (testBuildPopN() ? "OKAY" : "FAIL") << std::endl;
+	return 0;
+}
@@ -0,0 +1,48 @@
+#include <iostream>
+#include <queue>
+
+#include "external_priority_queue.hpp"
+
+int rand() {
+	static unsigned reed = 1727417277;
+	return (reed = reed * 1103515245u + 12345u) >> 1;
+}
+
+// a memory budget far below the data forces runs and run merges
+bool testSpill()
+{
+	sjtu::external_priority_queue<long long> q(1 << 12);
+	std::priority_queue<long long> ref;
+	size_t most = 0;
+	for (int i = 0; i < 300000; i++) {
+		if (rand() % 3 || ref.empty()) {
+			long long x = rand() % 1000000;
+			q.push(x);
+			ref.push(x);
+		} else {
+			if (q.top() != ref.top()) return false;
+			q.pop();
+			ref.pop();
+		}
+		if (q.size() != ref.size()) return false;
+		if (q.run_count() > most) most = q.run_count();
+	}
+	if (most < 2) return false;
+	while (!ref.empty()) {
+		if (q.top() != ref.top()) return false;
+		q.pop();
+		ref.pop();
+	}
+	try {
+		q.top();
+	} catch (sjtu::container_is_empty &) {
+		return q.empty();
+	}
+	return false;
+}
+
+int main()
+{
+	std::cout << (testSpill() ? "OKAY" : "FAIL") << std::endl;
+	return 0;
+}
@@ -0,0 +1,64 @@
+#include <iostream>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "indexed_dary_heap.hpp"
+
+int rand() {
+	static unsigned reed = 1727417277;
+	return (reed = reed * 1103515245u + 12345u) >> 1;
+}
+
+// push, update, erase and pop by id against a std::set of (priority, id)
+bool testIds()
+{
+	const size_t n = 1000;
+	sjtu::indexed_dary_heap<int> h(n);
+	std::set<std::pair<int, size_t>> ref;
+	std::vector<int> prio(n);
+	for (int i = 0; i < 200000; i++) {
+		size_t id = rand() % n;
+		int x = rand() % 100000;
+		int op = rand() % 4;
+		if (h.contains(id) != (ref.count({prio[id], id}) != 0)) return false;
+		if (!h.contains(id)) {
+			h.push(id, x);
+			ref.insert({x, id});
+			prio[id] = x;
+		} else if (op == 0) {
+			try {
+				h.push(id, x);
+				return false;
+			} catch (sjtu::runtime_error &) {}
+		} else if (op == 1) {
+			h.update(id, x);
+			ref.erase({prio[id], id});
+			ref.insert({x, id});
+			prio[id] = x;
+		} else if (op == 2) {
+			h.erase(id);
+			ref.erase({prio[id], id});
+		} else {
+			if (h.top() != ref.rbegin()->first) return false;
+			size_t top = h.top_id();
+			if (h.priority(top) != h.top()) return false;
+			ref.erase({prio[top], top});
+			h.pop();
+		}
+		if (h.size() != ref.size()) return false;
+		if (!ref.empty() && h.top() != ref.rbegin()->first) return false;
+	}
+	try {
+		h.push(n, 0);
+		return false;
+	} catch (sjtu::index_out_of_bound &) {}
+	while (!h.empty()) h.pop();
+	return h.capacity() == n;
+}
+
+int main()
+{
+	std::cout << (testIds() ? "OKAY" : "FAIL") << std::endl;
+	return 0;
+}
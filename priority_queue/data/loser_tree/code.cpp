@@ -0,0 +1,98 @@
+#include <algorithm>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "loser_tree.hpp"
+
+int rand() {
+	static unsigned reed = 1727417277;
+	return (reed = reed * 1103515245u + 12345u) >> 1;
+}
+
+typedef std::vector<std::pair<int, int>>::const_iterator iter;
+
+// compares the key only, the second member is the run
+class by_key {
+public:
+	bool operator()(const std::pair<int, int> &a, const std::pair<int, int> &b) const {
+		return a.first < b.first;
+	}
+};
+
+// k sorted runs, some empty, merge like a stable sort of their concatenation
+bool testMerge(int k)
+{
+	std::vector<std::vector<std::pair<int, int>>> runs(k);
+	std::vector<std::pair<int, int>> all;
+	for (int r = 0; r < k; r++) {
+		for (int i = rand() % 3 ? rand() % 500 : 0; i > 0; i--) runs[r].push_back({rand() % 100, r});
+		std::sort(runs[r].begin(), runs[r].end());
+		all.insert(all.end(), runs[r].begin(), runs[r].end());
+	}
+	std::stable_sort(all.begin(), all.end(), by_key());
+	std::vector<std::pair<iter, iter>> ends;
+	for (auto &r : runs) ends.push_back({r.cbegin(), r.cend()});
+	sjtu::loser_tree<iter, by_key> t(ends.begin(), ends.end());
+	if (t.runs() != size_t(k)) return false;
+	std::vector<std::pair<int, int>> out;
+	while (out.size() < all.size() / 2) {
+		if (int(t.top_run()) != t.top().second) return false;
+		out.push_back(t.top());
+		t.pop();
+	}
+	t.pop_n(all.size(), out);
+	return out == all && t.empty();
+}
+
+class boom {};
+
+// comparisons left before one throws, -1 for never
+int budget = -1;
+
+class fragile_less {
+public:
+	bool operator()(int a, int b) const {
+		if (budget == 0) throw boom();
+		if (budget > 0) --budget;
+		return a < b;
+	}
+};
+
+// pop_n retried after a throwing Compare returns every element once
+bool testThrow()
+{
+	std::vector<std::vector<int>> runs(9);
+	std::vector<int> all;
+	for (auto &r : runs) {
+		for (int i = rand() % 300; i > 0; i--) r.push_back(rand() % 1000);
+		std::sort(r.begin(), r.end());
+		all.insert(all.end(), r.begin(), r.end());
+	}
+	std::sort(all.begin(), all.end());
+	typedef std::vector<int>::const_iterator int_iter;
+	std::vector<std::pair<int_iter, int_iter>> ends;
+	for (auto &r : runs) ends.push_back({r.cbegin(), r.cend()});
+	sjtu::loser_tree<int_iter, fragile_less> t(ends.begin(), ends.end());
+	std::vector<int> out;
+	int thrown = 0;
+	while (!t.empty()) {
+		budget = rand() % 20;
+		try {
+			t.pop_n(rand() % 10, out);
+		} catch (boom &) {
+			thrown++;
+		}
+	}
+	budget = -1;
+	return out == all && thrown > 10;
+}
+
+int main()
+{
+	std::cout << (testMerge(1) ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (testMerge(7) ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (testMerge(64) ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (testThrow() ? "OKAY" : "FAIL") << std::endl;
+	return 0;
+}
@@ -0,0 +1,64 @@
+#include <iostream>
+#include <set>
+
+#include "minmax_heap.hpp"
+
+int rand() {
+	static unsigned reed = 1727417277;
+	return (reed = reed * 1103515245u + 12345u) >> 1;
+}
+
+// both ends against std::multiset
+bool testBothEnds()
+{
+	sjtu::minmax_heap<int> h;
+	std::multiset<int> ref;
+	for (int i = 0; i < 200000; i++) {
+		int op = rand() % 5;
+		if (op < 3 || ref.empty()) {
+			int x = rand() % 100000;
+			h.push(x);
+			ref.insert(x);
+		} else if (op == 3) {
+			h.pop_min();
+			ref.erase(ref.begin());
+		} else {
+			h.pop_max();
+			ref.erase(std::prev(ref.end()));
+		}
+		if (h.size() != ref.size()) return false;
+		if (!ref.empty() && (h.min() != *ref.begin() || h.max() != *ref.rbegin())) return false;
+	}
+	sjtu::minmax_heap<int> copy(h);
+	while (!ref.empty()) {
+		if (copy.max() != *ref.rbegin()) return false;
+		ref.erase(std::prev(ref.end()));
+		copy.pop_max();
+	}
+	return copy.empty() && !h.empty();
+}
+
+// the smallest heaps, where max() is the root or one of two children
+bool testSmall()
+{
+	sjtu::minmax_heap<int> h;
+	try {
+		h.max();
+		return false;
+	} catch (sjtu::container_is_empty &) {}
+	h.push(2);
+	if (h.min() != 2 || h.max() != 2) return false;
+	h.push(1);
+	h.push(3);
+	if (h.min() != 1 || h.max() != 3) return false;
+	h.pop_max();
+	h.pop_min();
+	return h.min() == 2 && h.max() == 2 && h.size() == 1;
+}
+
+int main()
+{
+	std::cout << (testBothEnds() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (testSmall() ? "OKAY" : "FAIL") << std::endl;
+	return 0;
+}
@@ -0,0 +1,62 @@
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "priority_queue.hpp"
+
+// orders the pointers by the values they point to
+class deref_less {
+public:
+	bool operator()(const std::unique_ptr<int> &a, const std::unique_ptr<int> &b) const {
+		return *a < *b;
+	}
+};
+
+// a move-only T goes in with push(T&&) and comes out with pop_value
+template<class Policy>
+bool testMoveOnly()
+{
+	sjtu::priority_queue<std::unique_ptr<int>, deref_less, Policy> q;
+	for (int i = 0; i < 1000; i++) {
+		std::unique_ptr<int> p(new int(i * 7 % 1000));
+		q.push(std::move(p));
+		if (p) return false;
+	}
+	q.emplace(new int(5000));
+	for (int i = 1000; i >= 0; i--) {
+		std::unique_ptr<int> p = q.pop_value();
+		if (!p || *p != (i == 1000 ? 5000 : i)) return false;
+	}
+	return q.empty();
+}
+
+// emplace builds the element from its constructor arguments
+template<class Policy>
+bool testEmplace()
+{
+	sjtu::priority_queue<std::string, std::less<std::string>, Policy> q;
+	q.emplace("two");
+	q.emplace(5, 'x');
+	std::string s = "one";
+	q.push(std::move(s));
+	if (q.size() != 3 || q.top() != "xxxxx") return false;
+	if (q.pop_value() != "xxxxx") return false;
+	if (q.pop_value() != "two") return false;
+	if (q.pop_value() != "one") return false;
+	try {
+		q.pop_value();
+	} catch (sjtu::container_is_empty &) {
+		return q.empty();
+	}
+	return false;
+}
+
+int main()
+{
+	std::cout << (testMoveOnly<sjtu::leftist_policy>() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (testMoveOnly<sjtu::pairing_policy>() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (testEmplace<sjtu::skew_policy>() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (testEmplace<sjtu::binomial_policy>() ? "OKAY" : "FAIL") << std::endl;
+	return 0;
+}
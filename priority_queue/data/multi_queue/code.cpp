@@ -0,0 +1,63 @@
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "multi_queue.hpp"
+#include "priority_queue.hpp"
+
+// every pushed element is popped exactly once, whatever the interleaving
+template<class Heap>
+bool testThreads()
+{
+	const int threads = 4, per = 50000;
+	sjtu::multi_queue<int, std::less<int>, Heap> q(threads);
+	std::vector<std::thread> pool;
+	for (int t = 0; t < threads; t++) {
+		pool.emplace_back([&q, t] {
+			for (int i = 0; i < per; i++) q.push(t * per + i);
+		});
+	}
+	for (auto &th : pool) th.join();
+	pool.clear();
+	if (q.size() != size_t(threads) * per) return false;
+	std::vector<std::vector<int>> got(threads);
+	for (int t = 0; t < threads; t++) {
+		pool.emplace_back([&q, &got, t] {
+			int x;
+			while (q.try_pop(x)) got[t].push_back(x);
+		});
+	}
+	for (auto &th : pool) th.join();
+	std::vector<char> seen(threads * per, 0);
+	for (auto &g : got) {
+		for (int x : g) {
+			if (x < 0 || x >= threads * per || seen[x]) return false;
+			seen[x] = 1;
+		}
+	}
+	for (char s : seen) {
+		if (!s) return false;
+	}
+	int x;
+	return q.empty() && !q.try_pop(x);
+}
+
+// with two heaps try_pop looks at both tops, so the order is exact
+bool testTwoHeaps()
+{
+	sjtu::multi_queue<int> q(1, 2);
+	for (int i = 0; i < 10000; i++) q.push(i * 7919 % 10000);
+	int x;
+	for (int i = 9999; i >= 0; i--) {
+		if (!q.try_pop(x) || x != i) return false;
+	}
+	return q.empty() && !q.try_pop(x);
+}
+
+int main()
+{
+	std::cout << (testThreads<sjtu::dary_heap<int>>() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (testThreads<sjtu::priority_queue<int>>() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (testTwoHeaps() ? "OKAY" : "FAIL") << std::endl;
+	return 0;
+}
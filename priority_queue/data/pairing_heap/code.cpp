@@ -0,0 +1,102 @@
+#include <iostream>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "pairing_heap.hpp"
+
+int rand() {
+	static unsigned reed = 1727417277;
+	return (reed = reed * 1103515245u + 12345u) >> 1;
+}
+
+typedef sjtu::pairing_heap<int> heap;
+
+// every element keeps a handle; keys move both ways and get erased
+bool testHandles()
+{
+	heap h;
+	std::multiset<int> ref;
+	std::vector<std::pair<heap::handle, int>> live;
+	for (int i = 0; i < 100000; i++) {
+		int op = rand() % 7;
+		if (op < 2 || live.empty()) {
+			int x = rand() % 100000;
+			live.push_back({h.push(x), x});
+			ref.insert(x);
+			continue;
+		}
+		size_t k = rand() % live.size();
+		heap::handle p = live[k].first;
+		int old = live[k].second, x = old;
+		if (op == 2) {
+			x = old + rand() % 1000;
+			h.decrease_key(p, x);
+		} else if (op == 3) {
+			x = old - rand() % 1000;
+			h.increase_key(p, x);
+		} else if (op == 4) {
+			x = rand() % 100000;
+			h.update(p, x);
+		} else if (op == 5) {
+			try {
+				h.decrease_key(p, old - 1);
+				return false;
+			} catch (sjtu::runtime_error &) {}
+			try {
+				h.increase_key(p, old + 1);
+				return false;
+			} catch (sjtu::runtime_error &) {}
+		} else {
+			h.erase(p);
+			ref.erase(ref.find(old));
+			live[k] = live.back();
+			live.pop_back();
+		}
+		if (op < 6) {
+			ref.erase(ref.find(old));
+			ref.insert(x);
+			live[k].second = x;
+			if (h.get(p) != x) return false;
+		}
+		if (h.size() != ref.size()) return false;
+		if (!ref.empty() && h.top() != *ref.rbegin()) return false;
+	}
+	while (!ref.empty()) {
+		if (h.top() != *ref.rbegin()) return false;
+		ref.erase(std::prev(ref.end()));
+		h.pop();
+	}
+	return h.empty();
+}
+
+// handles of a merged heap stay valid, a copy is independent
+bool testMerge()
+{
+	heap a, b;
+	std::vector<heap::handle> hb;
+	for (int i = 0; i < 1000; i++) {
+		a.push(2 * i);
+		hb.push_back(b.push(2 * i + 1));
+	}
+	a.merge(b);
+	if (!b.empty() || a.size() != 2000 || a.top() != 1999) return false;
+	for (int i = 0; i < 1000; i += 2) a.erase(hb[i]);
+	a.decrease_key(hb[1], 5000);
+	heap c(a);
+	c.pop();
+	if (a.top() != 5000 || c.top() != 1999) return false;
+	int last = 5001, n = 0;
+	for (; !a.empty(); a.pop(), n++) {
+		if (a.top() > last) return false;
+		last = a.top();
+	}
+	return n == 1500;
+}
+
+int main()
+{
+	std::cout << (testHandles() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (testMerge() ? "OKAY" : "FAIL") << std::endl;
+	return 0;
+}
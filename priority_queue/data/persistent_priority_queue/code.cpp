@@ -0,0 +1,58 @@
+#include <iostream>
+#include <queue>
+#include <vector>
+
+#include "persistent_priority_queue.hpp"
+
+int rand() {
+	static unsigned reed = 1727417277;
+	return (reed = reed * 1103515245u + 12345u) >> 1;
+}
+
+typedef sjtu::persistent_priority_queue<int> pq;
+
+bool same(pq q, std::priority_queue<int> ref)
+{
+	if (q.size() != ref.size()) return false;
+	for (; !ref.empty(); ref.pop(), q = q.pop()) {
+		if (q.top() != ref.top()) return false;
+	}
+	return q.empty();
+}
+
+// every version keeps its elements while later ones are derived from it
+bool testVersions()
+{
+	std::vector<pq> ver(1);
+	std::vector<std::priority_queue<int>> ref(1);
+	for (int i = 0; i < 3000; i++) {
+		size_t v = rand() % ver.size();
+		int op = rand() % 4;
+		if (op < 2 || ref[v].empty()) {
+			int x = rand() % 10000;
+			ver.push_back(ver[v].push(x));
+			ref.push_back(ref[v]);
+			ref.back().push(x);
+		} else if (op == 2) {
+			ver.push_back(ver[v].pop());
+			ref.push_back(ref[v]);
+			ref.back().pop();
+		} else {
+			size_t u = rand() % ver.size();
+			ver.push_back(ver[v].merge(ver[u]));
+			std::priority_queue<int> both = ref[v], other = ref[u];
+			for (; !other.empty(); other.pop()) both.push(other.top());
+			ref.push_back(both);
+		}
+	}
+	for (size_t v = 0; v < ver.size(); v += 37) {
+		if (!same(ver[v], ref[v])) return false;
+	}
+	return same(ver.back(), ref.back());
+}
+
+int main()
+{
+	std::cout << (testVersions() ? "OKAY" : "FAIL") << std::endl;
+	return 0;
+}
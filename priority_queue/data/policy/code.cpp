@@ -0,0 +1,75 @@
+#include <iostream>
+#include <queue>
+#include <vector>
+
+#include "priority_queue.hpp"
+
+int rand() {
+	static unsigned reed = 1727417277;
+	return (reed = reed * 1103515245u + 12345u) >> 1;
+}
+
+template<class Policy>
+bool same(sjtu::priority_queue<int, std::less<int>, Policy> q, std::priority_queue<int> ref)
+{
+	if (q.size() != ref.size()) return false;
+	for (; !ref.empty(); ref.pop(), q.pop()) {
+		if (q.top() != ref.top()) return false;
+	}
+	return q.empty();
+}
+
+// push, pop, merge, copy and assignment against std::priority_queue
+template<class Policy>
+bool testPolicy()
+{
+	typedef sjtu::priority_queue<int, std::less<int>, Policy> pq;
+	std::vector<pq> qs(8);
+	std::vector<std::priority_queue<int>> ref(8);
+	for (int i = 0; i < 20000; i++) {
+		size_t a = rand() % 8, b = rand() % 8;
+		int op = rand() % 20;
+		if (op < 10 || ref[a].empty()) {
+			int x = rand() % 100000;
+			qs[a].push(x);
+			ref[a].push(x);
+		} else if (op < 17) {
+			if (qs[a].top() != ref[a].top()) return false;
+			qs[a].pop();
+			ref[a].pop();
+		} else if (op < 19) {
+			qs[a].merge(qs[b]);
+			if (a != b) {
+				for (; !ref[b].empty(); ref[b].pop()) ref[a].push(ref[b].top());
+			}
+			if (!qs[b].empty() && a != b) return false;
+		} else if (rand() % 2) {
+			pq copy(qs[b]);
+			qs[a] = copy;
+			ref[a] = ref[b];
+		} else {
+			qs[a] = qs[b];
+			ref[a] = ref[b];
+		}
+		if (qs[a].size() != ref[a].size()) return false;
+		if (!ref[a].empty() && qs[a].top() != ref[a].top()) return false;
+	}
+	for (size_t i = 0; i < qs.size(); i++) {
+		if (!same(qs[i], ref[i])) return false;
+	}
+	try {
+		pq().pop();
+	} catch (sjtu::container_is_empty &) {
+		return true;
+	}
+	return false;
+}
+
+int main()
+{
+	std::cout << (testPolicy<sjtu::leftist_policy>() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (testPolicy<sjtu::skew_policy>() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (testPolicy<sjtu::pairing_policy>() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (testPolicy<sjtu::binomial_policy>() ? "OKAY" : "FAIL") << std::endl;
+	return 0;
+}
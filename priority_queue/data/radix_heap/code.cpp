@@ -0,0 +1,80 @@
+#include <iostream>
+#include <set>
+#include <string>
+#include <utility>
+
+#include "radix_heap.hpp"
+
+int rand() {
+	static unsigned reed = 1727417277;
+	return (reed = reed * 1103515245u + 12345u) >> 1;
+}
+
+// a key equal to the last popped one must not become the cached minimum
+bool testEqualKey()
+{
+	sjtu::radix_heap<unsigned, std::string> h;
+	h.push(10, "a");
+	h.push(20, "b");
+	if (h.top_key() != 10) return false;
+	h.push(0, "c");
+	h.pop();
+	if (h.top() != "a") return false;
+	h.pop();
+	if (h.top() != "b") return false;
+	h.pop();
+	if (!h.empty()) return false;
+	h.push(25, "d");
+	h.push(30, "e");
+	if (h.top_key() != 25) return false;
+	h.push(20, "f");
+	h.pop();
+	h.pop();
+	return h.top() == "e" && h.size() == 1;
+}
+
+// a Dijkstra-like run: pushed keys are never below the last popped one
+bool testRandom()
+{
+	sjtu::radix_heap<unsigned, int> h;
+	std::multiset<std::pair<unsigned, int>> ref;
+	unsigned last = 0;
+	for (int i = 0; i < 200000; i++) {
+		int op = rand() % 5;
+		if (op < 2 || ref.empty()) {
+			unsigned key = last + (rand() % 3 == 0 ? 0 : rand() % 1000);
+			h.push(key, i);
+			ref.insert({key, i});
+		} else if (op == 2) {
+			if (h.top_key() != ref.begin()->first) return false;
+		} else {
+			if (h.top_key() != ref.begin()->first) return false;
+			int v = h.top();
+			auto it = ref.lower_bound({h.top_key(), v});
+			if (it == ref.end() || it->second != v) return false;
+			last = it->first;
+			ref.erase(it);
+			if (op == 3) h.pop();
+			else if (h.pop_value() != v) return false;
+		}
+		if (h.size() != ref.size()) return false;
+	}
+	sjtu::radix_heap<unsigned, int> copy(h);
+	while (!ref.empty()) {
+		if (copy.top_key() != ref.begin()->first) return false;
+		ref.erase(ref.lower_bound({copy.top_key(), copy.top()}));
+		copy.pop();
+	}
+	try {
+		h.push(last - 1, 0);
+		return last == 0;
+	} catch (...) {}
+	return copy.empty();
+}
+
+int main()
+{
+	std::cout << (testEqualKey() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (testRandom() ? "OKAY" : "FAIL") << std::endl;
+	return 0;
+}
@@ -0,0 +1,68 @@
+#include <algorithm>
+#include <iostream>
+#include <list>
+#include <queue>
+#include <sstream>
+#include <vector>
+
+#include "priority_queue.hpp"
+
+int rand() {
+	static unsigned reed = 1727417277;
+	return (reed = reed * 1103515245u + 12345u) >> 1;
+}
+
+template<class Policy>
+bool same(sjtu::priority_queue<int, std::less<int>, Policy> &q, std::vector<int> ref)
+{
+	std::sort(ref.begin(), ref.end());
+	if (q.size() != ref.size()) return false;
+	for (; !ref.empty(); ref.pop_back(), q.pop()) {
+		if (q.top() != ref.back()) return false;
+	}
+	return q.empty();
+}
+
+// the range constructor and push_range, from forward and input iterators
+template<class Policy>
+bool testRange()
+{
+	typedef sjtu::priority_queue<int, std::less<int>, Policy> pq;
+	for (size_t n : {0, 1, 2, 1000, 30000}) {
+		std::vector<int> all;
+		std::list<int> more;
+		std::ostringstream text;
+		for (size_t i = 0; i < n; i++) {
+			all.push_back(rand() % 1000);
+			more.push_back(rand() % 1000);
+			text << rand() % 1000 << ' ';
+		}
+		pq a(all.begin(), all.end());
+		if (!same(a, all)) return false;
+		std::istringstream in(text.str());
+		pq b{std::istream_iterator<int>(in), std::istream_iterator<int>()};
+		std::istringstream again(text.str());
+		std::vector<int> parsed{std::istream_iterator<int>(again), std::istream_iterator<int>()};
+		if (!same(b, parsed)) return false;
+		pq c(all.begin(), all.end());
+		c.push_range(more.begin(), more.end());
+		std::istringstream third(text.str());
+		c.push_range(std::istream_iterator<int>(third), std::istream_iterator<int>());
+		std::vector<int> both(all);
+		both.insert(both.end(), more.begin(), more.end());
+		both.insert(both.end(), parsed.begin(), parsed.end());
+		c.push(-1);
+		both.push_back(-1);
+		if (!same(c, both)) return false;
+	}
+	return true;
+}
+
+int main()
+{
+	std::cout << (testRange<sjtu::leftist_policy>() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (testRange<sjtu::skew_policy>() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (testRange<sjtu::pairing_policy>() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (testRange<sjtu::binomial_policy>() ? "OKAY" : "FAIL") << std::endl;
+	return 0;
+}
@@ -0,0 +1,110 @@
+#include <iostream>
+#include <queue>
+#include <vector>
+
+#include "priority_queue.hpp"
+
+int rand() {
+	static unsigned reed = 1727417277;
+	return (reed = reed * 1103515245u + 12345u) >> 1;
+}
+
+class boom {};
+
+// comparisons left before one throws, -1 for never
+int budget = -1;
+
+class fragile_less {
+public:
+	bool operator()(int a, int b) const {
+		if (budget == 0) throw boom();
+		if (budget > 0) --budget;
+		return a < b;
+	}
+};
+
+template<class Policy>
+bool same(const sjtu::priority_queue<int, fragile_less, Policy> &q, std::priority_queue<int> ref)
+{
+	sjtu::priority_queue<int, fragile_less, Policy> copy(q);
+	if (copy.size() != ref.size()) return false;
+	for (; !ref.empty(); ref.pop(), copy.pop()) {
+		if (copy.top() != ref.top()) return false;
+	}
+	return copy.empty();
+}
+
+// replace_top is pop then push; a throwing Compare leaves the queue as it was
+template<class Policy>
+bool testReplaceTop()
+{
+	sjtu::priority_queue<int, fragile_less, Policy> q;
+	std::priority_queue<int> ref;
+	int thrown = 0;
+	for (int i = 0; i < 3000; i++) {
+		if (ref.size() < 200 && (rand() % 3 == 0 || ref.empty())) {
+			int x = rand() % 1000;
+			q.push(x);
+			ref.push(x);
+			continue;
+		}
+		int x = rand() % 1000;
+		budget = rand() % 2 ? rand() % 8 : -1;
+		try {
+			q.replace_top(x);
+			ref.pop();
+			ref.push(x);
+		} catch (boom &) {
+			thrown++;
+		}
+		budget = -1;
+		if (!same(q, ref)) return false;
+	}
+	return thrown > 100;
+}
+
+// pop_n appends largest first; on a throw the elements already appended
+// are gone from the queue and the rest is still in it
+template<class Policy>
+bool testPopN()
+{
+	sjtu::priority_queue<int, fragile_less, Policy> q;
+	std::priority_queue<int> ref;
+	int thrown = 0;
+	for (int i = 0; i < 2000; i++) {
+		for (int j = ref.size() < 300 ? rand() % 10 : 0; j > 0; j--) {
+			int x = rand() % 1000;
+			q.push(x);
+			ref.push(x);
+		}
+		std::vector<int> out;
+		budget = rand() % 2 ? rand() % 30 : -1;
+		size_t k = rand() % 8, n = 0;
+		try {
+			n = q.pop_n(k, out);
+			if (n != out.size() || n > k || (n < k && !q.empty())) return false;
+		} catch (boom &) {
+			thrown++;
+		}
+		budget = -1;
+		for (int x : out) {
+			if (ref.empty() || x != ref.top()) return false;
+			ref.pop();
+		}
+		if (!same(q, ref)) return false;
+	}
+	return thrown > 100;
+}
+
+int main()
+{
+	std::cout << (testReplaceTop<sjtu::leftist_policy>() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (testReplaceTop<sjtu::skew_policy>() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (testReplaceTop<sjtu::pairing_policy>() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (testReplaceTop<sjtu::binomial_policy>() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (testPopN<sjtu::leftist_policy>() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (testPopN<sjtu::skew_policy>() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (testPopN<sjtu::pairing_policy>() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (testPopN<sjtu::binomial_policy>() ? "OKAY" : "FAIL") << std::endl;
+	return 0;
+}
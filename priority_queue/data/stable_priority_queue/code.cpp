@@ -0,0 +1,46 @@
+#include <iostream>
+#include <utility>
+
+#include "stable_priority_queue.hpp"
+
+int rand() {
+	static unsigned reed = 1727417277;
+	return (reed = reed * 1103515245u + 12345u) >> 1;
+}
+
+// compares the key only, the second member records the push order
+class by_key {
+public:
+	bool operator()(const std::pair<int, int> &a, const std::pair<int, int> &b) const {
+		return a.first < b.first;
+	}
+};
+
+// equal keys come out in push order, also across a merge
+template<class Policy>
+bool testOrder()
+{
+	sjtu::stable_priority_queue<std::pair<int, int>, by_key, Policy> a, b;
+	for (int i = 0; i < 20000; i++) {
+		if (rand() % 2) a.push({rand() % 50, i});
+		else b.push({rand() % 50, i});
+	}
+	a.merge(b);
+	if (!b.empty() || a.size() != 20000) return false;
+	std::pair<int, int> last(50, -1);
+	while (!a.empty()) {
+		std::pair<int, int> cur = a.pop_value();
+		if (cur.first > last.first) return false;
+		if (cur.first == last.first && cur.second < last.second) return false;
+		last = cur;
+	}
+	return true;
+}
+
+int main()
+{
+	std::cout << (testOrder<sjtu::leftist_policy>() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (testOrder<sjtu::pairing_policy>() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (testOrder<sjtu::binomial_policy>() ? "OKAY" : "FAIL") << std::endl;
+	return 0;
+}
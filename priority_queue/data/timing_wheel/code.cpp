@@ -0,0 +1,71 @@
+#include <iostream>
+#include <map>
+#include <vector>
+
+#include "timing_wheel.hpp"
+
+int rand() {
+	static unsigned reed = 1727417277;
+	return (reed = reed * 1103515245u + 12345u) >> 1;
+}
+
+// every timer fires once, at its deadline or on the tick after scheduling
+bool testFire()
+{
+	typedef sjtu::timing_wheel<int, 4, 3> wheel; // the wheel spans 4096 ticks
+	wheel w(100);
+	std::map<int, uint64_t> expect;
+	std::map<int, wheel::timer> live;
+	bool ok = true;
+	int id = 0;
+	for (int round = 0; round < 2000; round++) {
+		for (int i = rand() % 8; i > 0; i--) {
+			uint64_t d = w.now() + rand() % 20000;
+			if (rand() % 10 == 0) d = w.now() - rand() % 50;
+			expect[id] = d > w.now() ? d : w.now() + 1;
+			live[id] = w.schedule(d, id);
+			id++;
+		}
+		if (!live.empty() && rand() % 3 == 0) {
+			auto it = live.lower_bound(rand() % id);
+			if (it == live.end()) it = live.begin();
+			if (w.get(it->second) != it->first) return false;
+			w.cancel(it->second);
+			expect.erase(it->first);
+			live.erase(it);
+		}
+		w.advance(rand() % 64, [&] (int &v) {
+			auto it = expect.find(v);
+			if (it == expect.end() || it->second != w.now()) ok = false;
+			else expect.erase(it);
+			live.erase(v);
+		});
+		if (!ok || w.size() != expect.size()) return false;
+	}
+	w.advance(30000, [&] (int &v) {
+		auto it = expect.find(v);
+		if (it == expect.end() || it->second != w.now()) ok = false;
+		else expect.erase(it);
+	});
+	return ok && w.empty() && expect.empty();
+}
+
+// expire may schedule new timers, which fire on later ticks
+bool testReschedule()
+{
+	sjtu::timing_wheel<int> w;
+	std::vector<uint64_t> ticks;
+	w.schedule(5, 0);
+	w.advance(100, [&] (int &v) {
+		ticks.push_back(w.now());
+		if (v < 3) w.schedule(w.now() + 10, v + 1);
+	});
+	return ticks == std::vector<uint64_t>{5, 15, 25, 35} && w.empty() && w.now() == 100;
+}
+
+int main()
+{
+	std::cout << (testFire() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (testReschedule() ? "OKAY" : "FAIL") << std::endl;
+	return 0;
+}
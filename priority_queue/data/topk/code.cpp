@@ -0,0 +1,54 @@
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+#include "topk.hpp"
+
+int rand() {
+	static unsigned reed = 1727417277;
+	return (reed = reed * 1103515245u + 12345u) >> 1;
+}
+
+// the kept elements are the k largest, extracted largest first
+bool testLargest(size_t k)
+{
+	sjtu::topk<int> t(k);
+	std::vector<int> all;
+	for (int i = 0; i < 100000; i++) {
+		int x = rand() % 1000000;
+		all.push_back(x);
+		bool kept = t.offer(x);
+		if (t.size() != std::min(all.size(), k)) return false;
+		if (kept && t.full() && t.threshold() > x) return false;
+	}
+	std::sort(all.begin(), all.end(), std::greater<int>());
+	all.resize(k);
+	if (t.threshold() != all.back()) return false;
+	std::vector<int> out(k);
+	t.extract_sorted(out.begin());
+	return out == all && t.empty();
+}
+
+// the range offer with another Compare keeps the k smallest
+bool testRange()
+{
+	std::vector<int> all;
+	for (int i = 0; i < 5000; i++) all.push_back(rand() % 100);
+	sjtu::topk<int, std::greater<int>> t(50);
+	t.offer(all.begin(), all.end());
+	std::sort(all.begin(), all.end());
+	all.resize(50);
+	std::vector<int> out;
+	t.extract_sorted(std::back_inserter(out));
+	sjtu::topk<int> none(0);
+	return out == all && none.offer(all.begin(), all.end()) == 0 && none.empty();
+}
+
+int main()
+{
+	std::cout << (testLargest(1) ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (testLargest(100) ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (testRange() ? "OKAY" : "FAIL") << std::endl;
+	return 0;
+}
@@ -0,0 +1,300 @@
+#ifndef SJTU_COMPACT_PRIORITY_QUEUE_HPP
+#define SJTU_COMPACT_PRIORITY_QUEUE_HPP
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "exceptions.hpp"
+
+namespace sjtu {
+/**
+ * a leftist heap like priority_queue, laid out for small T.
+ * The nodes live in one growing array and refer to each other by 32-bit
+ * indices; the null path length takes a byte. For an int that is a
+ * 16-byte node instead of 24, and a single allocation for all nodes.
+ *
+ * push, pop: O(logn). merge moves the slots of the queue with the smaller
+ * arena into the larger one. The arenas are compared by used slots, the
+ * most elements each held at once, not by size(): the cost is
+ * O(min(u, v) + logn) for u and v used slots. A slot moves only into an
+ * arena at least twice as full, so it moves O(logU) times over any
+ * sequence of merges, for U slots in total.
+ * If Compare throws, the queues are left unchanged.
+ */
+template<typename T, class Compare = std::less<T>>
+class compact_priority_queue {
+private:
+  typedef uint32_t index;
+  static constexpr index nil = UINT32_MAX;
+  static constexpr uint8_t dead = UINT8_MAX; // rank of a free slot
+
+  class node {
+  public:
+    index left, right; // left links the free slots
+    uint8_t rank;      // null path length + 1, 0 for nil
+    alignas(T) unsigned char buf[sizeof(T)];
+    T* val() { return reinterpret_cast<T*>(buf); }
+  };
+
+  node* a;
+  index cap, used; // slots [0, used) have been handed out
+  index free_head;
+  index root;
+  size_t siz;
+
+public:
+  compact_priority_queue() : a(nullptr), cap(0), used(0), free_head(nil), root(nil), siz(0) {}
+  compact_priority_queue(const compact_priority_queue &other)
+          : a(nullptr), cap(0), used(0), free_head(other.free_head), root(other.root), siz(other.siz) {
+    if(!other.used) return;
+    a = alloc(other.used);
+    cap = other.used;
+    try {
+      for(; used < other.used; ++used) {
+        node &src = other.a[used];
+        a[used].left = src.left;
+        a[used].right = src.right;
+        a[used].rank = src.rank;
+        if(src.rank != dead) new(a[used].buf) T(*src.val());
+      }
+    }
+    catch(...) {
+      destroy();
+      throw;
+    }
+  }
+  ~compact_priority_queue() {
+    destroy();
+  }
+  compact_priority_queue &operator=(const compact_priority_queue &other) {
+    if(this == &other) return *this;
+    compact_priority_queue tmp(other);
+    swap(tmp);
+    return *this;
+  }
+  void swap(compact_priority_queue &other) {
+    std::swap(a, other.a);
+    std::swap(cap, other.cap);
+    std::swap(used, other.used);
+    std::swap(free_head, other.free_head);
+    std::swap(root, other.root);
+    std::swap(siz, other.siz);
+  }
+  /**
+   * get the top of the queue.
+   * throw container_is_empty if empty() returns true;
+   */
+  const T & top() const {
+    if(empty()) throw container_is_empty();
+    return *a[root].val();
+  }
+  void push(const T &e) {
+    emplace(e);
+  }
+  void push(T &&e) {
+    emplace(std::move(e));
+  }
+  template<class... Args>
+  void emplace(Args&&... args) {
+    index add = allocate();
+    try {
+      new(a[add].buf) T(std::forward<Args>(args)...);
+    }
+    catch(...) {
+      release(add);
+      throw;
+    }
+    a[add].left = a[add].right = nil;
+    a[add].rank = 1;
+    try {
+      root = fuse(root, add);
+    }
+    catch(...) {
+      a[add].val()->~T();
+      release(add);
+      throw;
+    }
+    ++siz;
+  }
+  /**
+   * throw container_is_empty if empty() returns true;
+   */
+  void pop() {
+    if(empty()) throw container_is_empty();
+    index old = root;
+    root = fuse(a[old].left, a[old].right);
+    --siz;
+    a[old].val()->~T();
+    release(old);
+  }
+  /**
+   * delete the top element and return it, moved out of the queue.
+   * throw container_is_empty if empty() returns true;
+   */
+  T pop_value() {
+    if(empty()) throw container_is_empty();
+    index old = root;
+    root = fuse(a[old].left, a[old].right);
+    --siz;
+    class guard {
+    public:
+      compact_priority_queue* q;
+      index i;
+      ~guard() {
+        q->a[i].val()->~T();
+        q->release(i);
+      }
+    } hold{this, old};
+    return std::move(*a[old].val());
+  }
+  size_t size() const {
+    return siz;
+  }
+  bool empty() const {
+    return root == nil;
+  }
+  /**
+   * merge other into this and clear other.
+   */
+  void merge(compact_priority_queue &other) {
+    if(this == &other || other.empty()) return;
+    bool swapped = used < other.used;
+    if(swapped) swap(other); // keep the larger arena, moving costs other.used
+    index off = used;
+    // other's slots move to [off, off + other.used) with the same layout
+    index k = 0;
+    try {
+      reserve(size_t(off) + other.used);
+      for(; k < other.used; ++k) {
+        node &src = other.a[k];
+        node &dst = a[off + k];
+        dst.left = shift(src.left, off);
+        dst.right = shift(src.right, off);
+        dst.rank = src.rank;
+        if(src.rank != dead) {
+          new(dst.buf) T(std::move(*src.val()));
+          src.val()->~T();
+        }
+      }
+      used = off + other.used;
+      root = fuse(root, shift(other.root, off));
+    }
+    catch(...) { // move the slots back
+      used = off;
+      for(index j = 0; j < k; ++j) {
+        if(other.a[j].rank == dead) continue;
+        new(other.a[j].buf) T(std::move(*a[off + j].val()));
+        a[off + j].val()->~T();
+      }
+      if(swapped) swap(other);
+      throw;
+    }
+    // Free slots of other join the free list
+    if(other.free_head != nil) {
+      index last = other.free_head;
+      while(other.a[last].left != nil) last = other.a[last].left;
+      a[off + last].left = free_head;
+      free_head = off + other.free_head;
+    }
+    siz += other.siz;
+    other.used = 0;
+    other.free_head = other.root = nil;
+    other.siz = 0;
+  }
+
+private:
+  static node* alloc(size_t n) {
+    node* p = (node*) malloc(n * sizeof(node));
+    if(!p) throw std::bad_alloc();
+    return p;
+  }
+  static index shift(index i, index off) {
+    return i == nil ? nil : index(i + off);
+  }
+  void destroy() {
+    if(!std::is_trivially_destructible<T>::value) {
+      for(index i = 0; i < used; ++i) {
+        if(a[i].rank != dead) a[i].val()->~T();
+      }
+    }
+    free(a);
+  }
+  // Make room for n slots, moving the values over
+  void reserve(size_t n) {
+    if(n <= cap) return;
+    if(n >= nil) throw runtime_error(); // indices are 32-bit
+    size_t want = cap ? size_t(cap) * 2 : 16;
+    if(want < n) want = n;
+    if(want > nil) want = nil;
+    node* b = alloc(want);
+    for(index i = 0; i < used; ++i) {
+      b[i].left = a[i].left;
+      b[i].right = a[i].right;
+      b[i].rank = a[i].rank;
+      if(a[i].rank != dead) {
+        new(b[i].buf) T(std::move(*a[i].val()));
+        a[i].val()->~T();
+      }
+    }
+    free(a);
+    a = b;
+    cap = index(want);
+  }
+  index allocate() {
+    if(free_head != nil) {
+      index i = free_head;
+      free_head = a[i].left;
+      return i;
+    }
+    if(used == cap) reserve(size_t(used) + 1);
+    a[used].rank = dead;
+    return used++;
+  }
+  void release(index i) {
+    a[i].rank = dead;
+    a[i].left = free_head;
+    free_head = i;
+  }
+  uint8_t rank(index i) const {
+    return i == nil ? 0 : a[i].rank;
+  }
+  /**
+   * the fuse of priority_queue over indices: walk down both right spines
+   * choosing the roots, then link them bottom-up.
+   */
+  index fuse(index x, index y) {
+    index path[2 * sizeof(size_t) * CHAR_BIT];
+    int len = 0;
+    while(x != nil && y != nil) {
+      if(Compare()(*a[x].val(), *a[y].val())) {
+        index t = x;
+        x = y;
+        y = t;
+      }
+      path[len++] = x;
+      x = a[x].right;
+    }
+    index cur = x != nil ? x : y;
+    while(len) {
+      node &p = a[path[--len]];
+      p.right = cur;
+      if(rank(p.left) < rank(p.right)) {
+        index t = p.left;
+        p.left = p.right;
+        p.right = t;
+      }
+      p.rank = rank(p.right) + 1;
+      cur = path[len];
+    }
+    return cur;
+  }
+};
+
+}
+
+#endif
@@ -0,0 +1,265 @@
+#ifndef SJTU_DARY_HEAP_HPP
+#define SJTU_DARY_HEAP_HPP
+
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <utility>
+#include "exceptions.hpp"
+
+namespace sjtu {
+/**
+ * an array-backed d-ary heap with the interface of priority_queue
+ * (without merge). Elements are stored contiguously, children of i
+ * are D * i + 1 ... D * i + D.
+ * Like priority_queue, the heap is left unchanged if Compare throws:
+ * push and pop first find the final position with comparisons only,
+ * then move the elements along the path.
+ */
+template<typename T, class Compare = std::less<T>, int D = 4>
+class dary_heap {
+  static_assert(D >= 2, "a heap node needs at least two children");
+private:
+  size_t siz, capacity;
+  T* data;
+
+public:
+  dary_heap() : siz(0), capacity(16) {
+    data = alloc(capacity);
+  }
+  dary_heap(const dary_heap &other) : siz(0), capacity(other.siz ? other.siz : 16) {
+    data = alloc(capacity);
+    try {
+      for(; siz < other.siz; ++siz) {
+        new(data + siz) T(other.data[siz]);
+      }
+    }
+    catch(...) {
+      destroy();
+      throw;
+    }
+  }
+  /**
+   * heapify [first, last) bottom-up in O(n).
+   */
+  template<class InputIt>
+  dary_heap(InputIt first, InputIt last) : siz(0), capacity(16) {
+    data = alloc(capacity);
+    try {
+      for(; first != last; ++first) {
+        if(siz == capacity) expand();
+        new(data + siz) T(*first);
+        ++siz;
+      }
+      for(size_t i = siz > 1 ? (siz - 2) / D + 1 : 0; i-- > 0; ) {
+        sift_down(i);
+      }
+    }
+    catch(...) {
+      destroy();
+      throw;
+    }
+  }
+  ~dary_heap() {
+    destroy();
+  }
+  dary_heap &operator=(const dary_heap &other) {
+    if(this == &other) return *this;
+    dary_heap tmp(other);
+    swap(tmp);
+    return *this;
+  }
+  void swap(dary_heap &other) {
+    std::swap(siz, other.siz);
+    std::swap(capacity, other.capacity);
+    std::swap(data, other.data);
+  }
+  /**
+   * get the top of the queue.
+   * throw container_is_empty if empty() returns true;
+   */
+  const T & top() const {
+    if(empty()) throw container_is_empty();
+    return data[0];
+  }
+  void push(const T &e) {
+    emplace(e);
+  }
+  void push(T &&e) {
+    emplace(std::move(e));
+  }
+  /**
+   * construct the element in place from args.
+   */
+  template<class... Args>
+  void emplace(Args&&... args) {
+    if(siz == capacity) expand();
+    new(data + siz) T(std::forward<Args>(args)...);
+    // Find the slot first, nothing moves if Compare throws
+    size_t hole = siz;
+    try {
+      while(hole > 0 && Compare()(data[(hole - 1) / D], data[siz])) {
+        hole = (hole - 1) / D;
+      }
+    }
+    catch(...) {
+      data[siz].~T();
+      throw;
+    }
+    if(hole == siz) {
+      ++siz;
+      return;
+    }
+    T val = std::move(data[siz]);
+    for(size_t i = siz; i != hole; i = (i - 1) / D) {
+      data[i] = std::move(data[(i - 1) / D]);
+    }
+    data[hole] = std::move(val);
+    ++siz;
+  }
+  /**
+   * delete the top element.
+   * throw container_is_empty if empty() returns true;
+   */
+  void pop() {
+    if(empty()) throw container_is_empty();
+    size_t path[sizeof(size_t) * 8];
+    remove_top(path, plan_pop(path));
+  }
+  /**
+   * delete the top element and return it, moved out of the heap.
+   * throw container_is_empty if empty() returns true;
+   */
+  T pop_value() {
+    if(empty()) throw container_is_empty();
+    size_t path[sizeof(size_t) * 8];
+    int len = plan_pop(path);
+    T ret(std::move(data[0]));
+    remove_top(path, len);
+    return ret;
+  }
+  /**
+   * replace the top element by e, the same as pop() then push(e)
+   * but with a single pass down from the root.
+   * throw container_is_empty if empty() returns true;
+   */
+  void replace_top(const T &e) {
+    if(empty()) throw container_is_empty();
+    T val(e);
+    sink_top(val);
+  }
+  void replace_top(T &&e) {
+    if(empty()) throw container_is_empty();
+    T val(std::move(e));
+    sink_top(val);
+  }
+  /**
+   * pop up to k elements, largest first, appending them to out
+   * (e.g. a sjtu::vector) with push_back.
+   * @return the number of elements popped.
+   */
+  template<class Container>
+  size_t pop_n(size_t k, Container &out) {
+    size_t n = 0;
+    for(; n < k && !empty(); ++n) {
+      size_t path[sizeof(size_t) * 8];
+      int len = plan_pop(path);
+      out.push_back(std::move(data[0]));
+      remove_top(path, len);
+    }
+    return n;
+  }
+  size_t size() const {
+    return siz;
+  }
+  bool empty() const {
+    return siz == 0;
+  }
+  /**
+   * make room for n elements, so that pushing up to n does not allocate.
+   */
+  void reserve(size_t n) {
+    if(n <= capacity) return;
+    T* n_data = alloc(n);
+    for(size_t i = 0; i < siz; ++i) {
+      new(n_data + i) T(std::move(data[i]));
+      data[i].~T();
+    }
+    free(data);
+    data = n_data;
+    capacity = n;
+  }
+
+private:
+  static T* alloc(size_t n) {
+    T* p = (T*) malloc(n * sizeof(T));
+    if(!p) throw std::bad_alloc();
+    return p;
+  }
+  void destroy() {
+    for(size_t i = 0; i < siz; ++i) {
+      data[i].~T();
+    }
+    free(data);
+  }
+  /**
+   * find the children val has to pass when it sinks from hole within
+   * data[0, n), with comparisons only.
+   */
+  int plan_down(size_t hole, const T &val, size_t n, size_t* path) const {
+    int len = 0;
+    while(true) {
+      size_t first = D * hole + 1;
+      if(first >= n) break;
+      size_t last = first + D < n ? first + D : n;
+      size_t best = first;
+      for(size_t c = first + 1; c < last; ++c) {
+        if(Compare()(data[best], data[c])) best = c;
+      }
+      if(!Compare()(val, data[best])) break;
+      path[len++] = best;
+      hole = best;
+    }
+    return len;
+  }
+  // Move the children on path up one level each, return the freed slot
+  size_t shift_up(size_t hole, const size_t* path, int len) {
+    for(int k = 0; k < len; ++k) {
+      data[hole] = std::move(data[path[k]]);
+      hole = path[k];
+    }
+    return hole;
+  }
+  // The last element fills the hole left by the top
+  int plan_pop(size_t* path) const {
+    return plan_down(0, data[siz - 1], siz - 1, path);
+  }
+  void remove_top(const size_t* path, int len) {
+    size_t n = siz - 1;
+    size_t cur = shift_up(0, path, len);
+    if(cur != n) data[cur] = std::move(data[n]);
+    data[n].~T();
+    --siz;
+  }
+  // Move data[start] down to where it belongs, same scheme as pop
+  void sift_down(size_t start) {
+    size_t path[sizeof(size_t) * 8];
+    int len = plan_down(start, data[start], siz, path);
+    if(!len) return;
+    T val = std::move(data[start]);
+    data[shift_up(start, path, len)] = std::move(val);
+  }
+  void sink_top(T &val) {
+    size_t path[sizeof(size_t) * 8];
+    int len = plan_down(0, val, siz, path);
+    data[shift_up(0, path, len)] = std::move(val);
+  }
+  void expand() {
+    reserve(capacity * 2);
+  }
+};
+
+}
+
+#endif
@@ -0,0 +1,243 @@
+#ifndef SJTU_EXTERNAL_PRIORITY_QUEUE_HPP
+#define SJTU_EXTERNAL_PRIORITY_QUEUE_HPP
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include "dary_heap.hpp"
+#include "exceptions.hpp"
+
+namespace sjtu {
+/**
+ * a priority queue that keeps most of its elements in temporary files.
+ *
+ * New elements go to an in-memory insertion heap. When it is full, it is
+ * written out largest first as a sorted run. Every run keeps one block in
+ * memory, and a merge heap over the run heads yields the largest of them.
+ * top and pop take the larger of the two heaps. When the runs would take
+ * more than their share of memory, they are merged into a single run.
+ *
+ * Memory use stays near memory_bytes: half for the insertion heap, half
+ * for the run blocks. Both heaps are sized once by the constructor and
+ * never grow. Files come from std::tmpfile and are removed on close.
+ * T is written byte for byte, so it has to be trivially copyable.
+ * A failed file operation throws runtime_error.
+ */
+template<typename T, class Compare = std::less<T>>
+class external_priority_queue {
+  static_assert(std::is_trivially_copyable<T>::value, "elements are stored as raw bytes");
+private:
+  class run {
+  public:
+    std::FILE* file;
+    T* buf;
+    size_t pos, len; // the unread part of buf is [pos, len)
+    size_t left;     // elements still in the file
+  };
+  class head {
+  public:
+    T value;
+    size_t src; // index of the run
+  };
+  class head_less {
+  public:
+    bool operator()(const head &a, const head &b) const {
+      return Compare()(a.value, b.value);
+    }
+  };
+
+  size_t siz;
+  size_t insert_cap, block, max_runs;
+  dary_heap<T, Compare> ins;
+  dary_heap<head, head_less> heads;
+  run* runs; // free slots have no file
+  size_t nruns;
+  T* out; // write buffer for spilling
+
+public:
+  explicit external_priority_queue(size_t memory_bytes = size_t(64) << 20) : siz(0), nruns(0) {
+    size_t half = memory_bytes / 2;
+    insert_cap = half / sizeof(T) ? half / sizeof(T) : 1;
+    size_t block_bytes = memory_bytes / 16 < (size_t(1) << 16) ? memory_bytes / 16 : size_t(1) << 16;
+    block = block_bytes / sizeof(T) ? block_bytes / sizeof(T) : 1;
+    max_runs = half / (block * sizeof(T));
+    if(max_runs < 2) max_runs = 2;
+    runs = (run*) malloc(max_runs * sizeof(run));
+    out = (T*) malloc(block * sizeof(T));
+    if(!runs || !out) {
+      free(runs);
+      free(out);
+      throw std::bad_alloc();
+    }
+    for(size_t i = 0; i < max_runs; ++i) runs[i].file = nullptr;
+    try {
+      ins.reserve(insert_cap);
+      heads.reserve(max_runs);
+    }
+    catch(...) {
+      free(runs);
+      free(out);
+      throw;
+    }
+  }
+  external_priority_queue(const external_priority_queue &) = delete;
+  external_priority_queue &operator=(const external_priority_queue &) = delete;
+  ~external_priority_queue() {
+    for(size_t i = 0; i < max_runs; ++i) {
+      if(runs[i].file) close(runs[i]);
+    }
+    free(runs);
+    free(out);
+  }
+
+  /**
+   * get the top of the queue.
+   * throw container_is_empty if empty() returns true;
+   */
+  const T & top() const {
+    if(empty()) throw container_is_empty();
+    if(from_runs()) return heads.top().value;
+    return ins.top();
+  }
+  void push(const T &e) {
+    if(ins.size() == insert_cap) spill();
+    ins.push(e);
+    ++siz;
+  }
+  /**
+   * delete the top element.
+   * throw container_is_empty if empty() returns true;
+   */
+  void pop() {
+    if(empty()) throw container_is_empty();
+    if(from_runs()) {
+      advance(heads.top().src, true);
+    }
+    else {
+      ins.pop();
+    }
+    --siz;
+  }
+  size_t size() const {
+    return siz;
+  }
+  bool empty() const {
+    return siz == 0;
+  }
+  // The number of runs on disk
+  size_t run_count() const {
+    return nruns;
+  }
+
+private:
+  bool from_runs() const {
+    if(heads.empty()) return false;
+    return ins.empty() || Compare()(ins.top(), heads.top().value);
+  }
+  static std::FILE* open_file() {
+    std::FILE* f = std::tmpfile();
+    if(!f) throw runtime_error();
+    std::setvbuf(f, nullptr, _IONBF, 0); // the blocks are the buffers
+    return f;
+  }
+  void close(run &r) {
+    std::fclose(r.file);
+    free(r.buf);
+    r.file = nullptr;
+    --nruns;
+  }
+  void write(std::FILE* f, size_t n) {
+    if(std::fwrite(out, sizeof(T), n, f) != n) throw runtime_error();
+  }
+  // Read the next block of run r
+  void fill(run &r) {
+    size_t n = r.left < block ? r.left : block;
+    if(std::fread(r.buf, sizeof(T), n, r.file) != n) throw runtime_error();
+    r.pos = 0;
+    r.len = n;
+    r.left -= n;
+  }
+  /**
+   * the head of run r leaves the merge heap (if popping) and the next
+   * element of r takes its place; an exhausted run is closed.
+   */
+  void advance(size_t r, bool popping) {
+    run &cur = runs[r];
+    if(cur.pos == cur.len && cur.left) fill(cur);
+    if(cur.pos == cur.len) {
+      if(popping) heads.pop();
+      close(cur);
+      return;
+    }
+    head next{cur.buf[cur.pos++], r};
+    if(popping) heads.replace_top(next);
+    else heads.push(next);
+  }
+  // Turn a file holding n sorted elements into a run
+  void add_run(std::FILE* f, size_t n) {
+    run r{f, nullptr, 0, 0, n};
+    r.buf = (T*) malloc(block * sizeof(T));
+    if(!r.buf || std::fseek(f, 0, SEEK_SET)) {
+      free(r.buf);
+      std::fclose(f);
+      throw runtime_error();
+    }
+    size_t i = 0;
+    while(runs[i].file) ++i;
+    runs[i] = r;
+    ++nruns;
+    advance(i, false);
+  }
+  // Write the insertion heap out as a run, largest first
+  void spill() {
+    if(nruns == max_runs) compact();
+    std::FILE* f = open_file();
+    size_t n = ins.size(), k = 0;
+    try {
+      while(!ins.empty()) {
+        out[k++] = ins.pop_value();
+        if(k == block) {
+          write(f, k);
+          k = 0;
+        }
+      }
+      write(f, k);
+    }
+    catch(...) {
+      std::fclose(f);
+      siz -= n - ins.size(); // what was taken out is lost
+      throw;
+    }
+    add_run(f, n);
+  }
+  // Merge every run into one, freeing run slots
+  void compact() {
+    std::FILE* f = open_file();
+    size_t n = 0, k = 0;
+    try {
+      while(!heads.empty()) {
+        out[k] = heads.top().value;
+        advance(heads.top().src, true);
+        ++k, ++n;
+        if(k == block) {
+          write(f, k);
+          k = 0;
+        }
+      }
+      write(f, k);
+    }
+    catch(...) {
+      std::fclose(f);
+      siz -= n;
+      throw;
+    }
+    add_run(f, n);
+  }
+};
+
+}
+
+#endif
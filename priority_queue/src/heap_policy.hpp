@@ -0,0 +1,822 @@
+#ifndef SJTU_HEAP_POLICY_HPP
+#define SJTU_HEAP_POLICY_HPP
+
+/**
+ * Meldable heap algorithms for priority_queue.
+ *
+ * A policy P provides P::heap<T, Compare>, which only links nodes; the
+ * queue allocates them and keeps the size. Every heap offers
+ *   node                    with a member T content, constructed from
+ *                           (std::in_place, args...) or a node to copy
+ *   empty(), top()          top() returns the node at the top
+ *   push(node*)             link a fresh node
+ *   pop()                   unlink the top node and return it as fresh
+ *   replace_top(T &val)     move val into the top node and restore the order
+ *   merge(heap &)           take all nodes of the other heap
+ *   build(nodes, n, drop)   link n fresh nodes into an empty heap, O(n)
+ *   copy_from(h, make, drop), clear(drop), swap(heap &)
+ * If Compare throws inside push, pop, replace_top or merge, the heaps keep
+ * their elements and stay valid (a node given to push is not linked, the
+ * top keeps its old value).
+ * If it throws inside build, the heap stays empty and the nodes are dropped.
+ *
+ * All nodes hang in a binary tree through left/right (child/sibling
+ * for the multiway heaps), so copying and freeing are shared below.
+ */
+
+#include <climits>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <utility>
+
+namespace sjtu {
+
+class heap_tree {
+public:
+  /**
+   * copy the tree in preorder with a worklist, so nodes are allocated
+   * in visiting order and deep left paths cannot overflow the stack.
+   * make(const Node &) returns a new node copying the content and the
+   * bookkeeping of its argument. If it throws, the partial copy is dropped.
+   */
+  template<class Node, class Make, class Drop>
+  static Node* copy(const Node* other, Make &make, Drop &drop) {
+    if(!other) return nullptr;
+    class task {
+    public:
+      const Node* src;
+      Node** dst;
+    };
+    size_t cap = 64, top = 0;
+    task* work = (task*) malloc(cap * sizeof(task));
+    if(!work) throw std::bad_alloc();
+    Node* ret = nullptr;
+    work[top++] = task{other, &ret};
+    try {
+      while(top) {
+        task t = work[--top];
+        Node* cur = make(*t.src);
+        cur->left = cur->right = nullptr;
+        *t.dst = cur;
+        if(top + 2 > cap) {
+          task* bigger = (task*) realloc(work, cap * 2 * sizeof(task));
+          if(!bigger) throw std::bad_alloc();
+          work = bigger;
+          cap *= 2;
+        }
+        // Right first so that the left subtree is copied next
+        if(t.src->right) work[top++] = task{t.src->right, &cur->right};
+        if(t.src->left) work[top++] = task{t.src->left, &cur->left};
+      }
+    }
+    catch(...) {
+      free(work);
+      destroy(ret, drop); // unfilled children are still nullptr
+      throw;
+    }
+    free(work);
+    return ret;
+  }
+  /**
+   * meld the singleton heaps q[0, n) pairwise, round after round, like
+   * a FIFO queue of heaps: two heaps of size k cost O(logk) to meld, so
+   * the rounds sum up to O(n). If meld throws, every piece is dropped.
+   */
+  template<class Node, class Meld, class Drop>
+  static Node* pairwise(Node** q, size_t n, Meld meld, Drop &drop) {
+    if(!n) return nullptr;
+    size_t i = 0, w = 0;
+    try {
+      while(n > 1) {
+        for(i = 0, w = 0; i + 1 < n; i += 2) {
+          q[w++] = meld(q[i], q[i + 1]);
+        }
+        if(i < n) q[w++] = q[i];
+        n = w;
+      }
+    }
+    catch(...) {
+      for(size_t k = 0; k < w; ++k) destroy(q[k], drop);
+      for(size_t k = i; k < n; ++k) destroy(q[k], drop);
+      throw;
+    }
+    return q[0];
+  }
+  /**
+   * the walk of fuse for a top t that takes the new value val: the right
+   * spines of t's children and t itself, now childless, are merged into
+   * one sequence from the largest down. add(p) receives the sequence, the
+   * rest of the last spine is returned. Only Compare is called, nothing
+   * is linked.
+   */
+  template<class Compare, class Node, class T, class Add>
+  static Node* merge_top(Node* t, const T &val, Add add) {
+    Node* a = t->left;
+    Node* b = t->right;
+    bool placed = false, ordered = false;
+    while((a != nullptr) + (b != nullptr) + !placed >= 2) {
+      if(!ordered && (!a || (b && Compare()(a->content, b->content)))) {
+        Node* x = a;
+        a = b;
+        b = x;
+      }
+      ordered = false;
+      // a is the larger head of the two spines
+      if(!placed && !Compare()(val, a->content)) {
+        add(t);
+        placed = ordered = true;
+        continue;
+      }
+      add(a);
+      a = a->right;
+    }
+    if(!placed) add(t);
+    return a ? a : b;
+  }
+  // Whether val may take the place of t without moving: no child beats it
+  template<class Compare, class Node, class T>
+  static bool stays(Node* t, const T &val) {
+    if(t->left && Compare()(val, t->left->content)) return false;
+    return !t->right || !Compare()(val, t->right->content);
+  }
+  /**
+   * free the tree without recursion or extra memory:
+   * rotate left children up until the top has none, then drop it.
+   */
+  template<class Node, class Drop>
+  static void destroy(Node* p, Drop &drop) {
+    while(p) {
+      if(p->left) {
+        Node* l = p->left;
+        p->left = l->right;
+        l->right = p;
+        p = l;
+      }
+      else {
+        Node* nxt = p->right;
+        drop(p);
+        p = nxt;
+      }
+    }
+  }
+};
+
+/**
+ * leftist heap: merge walks the right spines, which are O(logn) long.
+ */
+class leftist_policy {
+public:
+  template<typename T, class Compare>
+  class heap {
+  public:
+    class node {
+    public:
+      node* left;
+      node* right;
+      int depth;
+      T content;
+      template<class... Args>
+      node(std::in_place_t, Args&&... args) : left(nullptr), right(nullptr), depth(0), content(std::forward<Args>(args)...) {}
+      node(const node &other) : left(nullptr), right(nullptr), depth(other.depth), content(other.content) {}
+    };
+
+  private:
+    node* root;
+
+  public:
+    heap() : root(nullptr) {}
+    heap(const heap &) = delete;
+    heap &operator=(const heap &) = delete;
+
+    bool empty() const {
+      return root == nullptr;
+    }
+    node* top() const {
+      return root;
+    }
+    void push(node* n) {
+      root = fuse(root, n);
+    }
+    node* pop() {
+      node* ret = root;
+      root = fuse(root->left, root->right);
+      ret->left = ret->right = nullptr;
+      ret->depth = 0;
+      return ret;
+    }
+    /**
+     * one walk from the root: the top, with val, is merged with the right
+     * spines of its children, or just takes val if it beats both.
+     */
+    void replace_top(T &val) {
+      node* t = root;
+      if(heap_tree::stays<Compare>(t, val)) {
+        t->content = std::move(val);
+        return;
+      }
+      node* path[2 * sizeof(size_t) * CHAR_BIT + 1];
+      int len = 0;
+      node* tail = heap_tree::merge_top<Compare>(t, val, [&] (node* p) { path[len++] = p; });
+      t->content = std::move(val);
+      t->left = t->right = nullptr;
+      t->depth = 0;
+      root = link(path, len, tail);
+    }
+    void merge(heap &other) {
+      root = fuse(root, other.root);
+      other.root = nullptr;
+    }
+    template<class Drop>
+    void build(node** nodes, size_t n, Drop drop) {
+      root = heap_tree::pairwise(nodes, n, fuse, drop);
+    }
+    template<class Make, class Drop>
+    void copy_from(const heap &other, Make make, Drop drop) {
+      root = heap_tree::copy(other.root, make, drop);
+    }
+    template<class Drop>
+    void clear(Drop drop) {
+      heap_tree::destroy(root, drop);
+      root = nullptr;
+    }
+    void swap(heap &other) {
+      node* tmp = root;
+      root = other.root;
+      other.root = tmp;
+    }
+
+  private:
+    static int dep(node* p) {
+      if(p) return p->depth;
+      return -1;
+    }
+    static void exchange(node* &x, node* &y) {
+      node* temp = x;
+      x = y;
+      y = temp;
+    }
+    /**
+     * fuse invalidate original relations.
+     * First walk down both right spines choosing the roots, then link them
+     * bottom-up. Compare is only called during the walk, so the heaps are
+     * untouched if it throws.
+     */
+    static node* fuse(node* x, node* y) {
+      // Both right spines hold at most log2(n + 1) nodes each
+      node* path[2 * sizeof(size_t) * CHAR_BIT];
+      int len = 0;
+      while(x && y) {
+        if(Compare()(x->content, y->content)) {
+          exchange(x, y);
+        }
+        // x is the root of this level
+        path[len++] = x;
+        x = x->right;
+      }
+      return link(path, len, x ? x : y);
+    }
+    // Hang every path node on the right of the one before, bottom-up
+    static node* link(node** path, int len, node* cur) {
+      while(len) {
+        node* p = path[--len];
+        p->right = cur;
+        if(dep(p->left) < dep(p->right)) {
+          exchange(p->left, p->right);
+        }
+        p->depth = dep(p->right) + 1;
+        cur = p;
+      }
+      return cur;
+    }
+  };
+};
+
+/**
+ * skew heap: a leftist heap without ranks that swaps children on every
+ * merge. O(logn) amortized, but a single right spine may be long, so the
+ * merge path is kept in a growable scratch buffer.
+ */
+class skew_policy {
+public:
+  template<typename T, class Compare>
+  class heap {
+  public:
+    class node {
+    public:
+      node* left;
+      node* right;
+      T content;
+      template<class... Args>
+      node(std::in_place_t, Args&&... args) : left(nullptr), right(nullptr), content(std::forward<Args>(args)...) {}
+      node(const node &other) : left(nullptr), right(nullptr), content(other.content) {}
+    };
+
+  private:
+    node* root;
+    node** path;
+    size_t cap;
+
+  public:
+    heap() : root(nullptr), path(nullptr), cap(0) {}
+    heap(const heap &) = delete;
+    heap &operator=(const heap &) = delete;
+    ~heap() {
+      free(path);
+    }
+
+    bool empty() const {
+      return root == nullptr;
+    }
+    node* top() const {
+      return root;
+    }
+    void push(node* n) {
+      root = fuse(root, n);
+    }
+    node* pop() {
+      node* ret = root;
+      root = fuse(root->left, root->right);
+      ret->left = ret->right = nullptr;
+      return ret;
+    }
+    // The walk of the leftist replace_top, linked the skew way
+    void replace_top(T &val) {
+      node* t = root;
+      if(heap_tree::stays<Compare>(t, val)) {
+        t->content = std::move(val);
+        return;
+      }
+      size_t len = 0;
+      node* tail = heap_tree::merge_top<Compare>(t, val, [&] (node* p) {
+        if(len == cap) grow();
+        path[len++] = p;
+      });
+      t->content = std::move(val);
+      t->left = t->right = nullptr;
+      root = link(len, tail);
+    }
+    void merge(heap &other) {
+      root = fuse(root, other.root);
+      other.root = nullptr;
+    }
+    template<class Drop>
+    void build(node** nodes, size_t n, Drop drop) {
+      root = heap_tree::pairwise(nodes, n, [this] (node* x, node* y) { return fuse(x, y); }, drop);
+    }
+    template<class Make, class Drop>
+    void copy_from(const heap &other, Make make, Drop drop) {
+      root = heap_tree::copy(other.root, make, drop);
+    }
+    template<class Drop>
+    void clear(Drop drop) {
+      heap_tree::destroy(root, drop);
+      root = nullptr;
+    }
+    void swap(heap &other) {
+      node* r = root;
+      root = other.root, other.root = r;
+      node** p = path;
+      path = other.path, other.path = p;
+      size_t c = cap;
+      cap = other.cap, other.cap = c;
+    }
+
+  private:
+    // Same two phases as the leftist fuse: choose roots, then link
+    node* fuse(node* x, node* y) {
+      size_t len = 0;
+      while(x && y) {
+        if(Compare()(x->content, y->content)) {
+          node* t = x;
+          x = y;
+          y = t;
+        }
+        if(len == cap) grow();
+        path[len++] = x;
+        x = x->right;
+      }
+      return link(len, x ? x : y);
+    }
+    node* link(size_t len, node* cur) {
+      while(len) {
+        node* p = path[--len];
+        p->right = p->left;
+        p->left = cur;
+        cur = p;
+      }
+      return cur;
+    }
+    void grow() {
+      size_t n = cap ? cap * 2 : 64;
+      node** bigger = (node**) realloc(path, n * sizeof(node*));
+      if(!bigger) throw std::bad_alloc();
+      path = bigger;
+      cap = n;
+    }
+  };
+};
+
+/**
+ * the pairing heap algorithms over left (first child) / right (next
+ * sibling) links, shared by pairing_policy and pairing_heap. If Node has
+ * a member prev (the parent for a first child, the left sibling
+ * otherwise), it is kept up to date as well.
+ */
+template<class Node, class Compare>
+class pairing_tree {
+  static constexpr bool has_prev = requires(Node* n) { n->prev; };
+
+public:
+  // Make b the first child of a
+  static void link(Node* a, Node* b) {
+    b->right = a->left;
+    if constexpr (has_prev) {
+      if(a->left) a->left->prev = b;
+      b->prev = a;
+    }
+    a->left = b;
+  }
+  // Compare before linking, so a throwing Compare changes nothing
+  static Node* meld(Node* x, Node* y) {
+    if(!x) return y;
+    if(!y) return x;
+    if(Compare()(x->content, y->content)) {
+      link(y, x);
+      return y;
+    }
+    link(x, y);
+    return x;
+  }
+  // Make the list starting at head the children of parent
+  static void adopt(Node* parent, Node* head) {
+    parent->left = head;
+    if constexpr (has_prev) {
+      Node* prev = parent;
+      for(Node* c = head; c; c = c->right) {
+        c->prev = prev;
+        prev = c;
+      }
+    }
+  }
+  /**
+   * two-pass pairing: meld the children of parent into a single child.
+   * If Compare throws, the pieces built so far become the children of
+   * parent again, so no element is lost and the heap order holds.
+   */
+  static void combine(Node* parent) {
+    Node* cur = parent->left;
+    if(!cur || !cur->right) return;
+    // First pass: meld pairs left to right, stack the winners
+    Node* stack = nullptr;
+    Node* stack_tail = nullptr;
+    try {
+      while(cur) {
+        Node* w = cur;
+        Node* b = cur->right;
+        if(b) {
+          Node* rest = b->right;
+          w = meld(cur, b);
+          cur = rest;
+        }
+        else {
+          cur = nullptr;
+        }
+        w->right = stack;
+        if(!stack) stack_tail = w;
+        stack = w;
+      }
+    }
+    catch(...) {
+      if(stack) {
+        stack_tail->right = cur;
+        adopt(parent, stack);
+      }
+      else {
+        adopt(parent, cur);
+      }
+      throw;
+    }
+    // Second pass: meld the winners right to left
+    Node* acc = stack;
+    stack = stack->right;
+    try {
+      while(stack) {
+        Node* w = stack;
+        Node* rest = w->right;
+        acc = meld(acc, w);
+        stack = rest;
+      }
+    }
+    catch(...) {
+      acc->right = stack;
+      adopt(parent, acc);
+      throw;
+    }
+    acc->right = nullptr;
+    adopt(parent, acc);
+  }
+};
+
+/**
+ * pairing heap: merge links two roots, pop melds the children of the
+ * root pairwise left to right, then right to left. left is the first
+ * child, right the next sibling.
+ */
+class pairing_policy {
+public:
+  template<typename T, class Compare>
+  class heap {
+  public:
+    class node {
+    public:
+      node* left;
+      node* right;
+      T content;
+      template<class... Args>
+      node(std::in_place_t, Args&&... args) : left(nullptr), right(nullptr), content(std::forward<Args>(args)...) {}
+      node(const node &other) : left(nullptr), right(nullptr), content(other.content) {}
+    };
+
+  private:
+    typedef pairing_tree<node, Compare> tree;
+
+    node* root;
+
+  public:
+    heap() : root(nullptr) {}
+    heap(const heap &) = delete;
+    heap &operator=(const heap &) = delete;
+
+    bool empty() const {
+      return root == nullptr;
+    }
+    node* top() const {
+      return root;
+    }
+    void push(node* n) {
+      root = tree::meld(root, n);
+    }
+    node* pop() {
+      tree::combine(root);
+      node* ret = root;
+      root = ret->left;
+      ret->left = nullptr;
+      return ret;
+    }
+    /**
+     * the children are combined as in pop, then val stays at the top
+     * if it beats the combined child, or the top becomes its first child.
+     */
+    void replace_top(T &val) {
+      tree::combine(root);
+      node* c = root->left;
+      bool sinks = c && Compare()(val, c->content);
+      root->content = std::move(val);
+      if(!sinks) return;
+      root->left = nullptr;
+      tree::link(c, root);
+      root = c;
+    }
+    void merge(heap &other) {
+      root = tree::meld(root, other.root);
+      other.root = nullptr;
+    }
+    template<class Drop>
+    void build(node** nodes, size_t n, Drop drop) {
+      root = heap_tree::pairwise(nodes, n, tree::meld, drop);
+    }
+    template<class Make, class Drop>
+    void copy_from(const heap &other, Make make, Drop drop) {
+      root = heap_tree::copy(other.root, make, drop);
+    }
+    template<class Drop>
+    void clear(Drop drop) {
+      heap_tree::destroy(root, drop);
+      root = nullptr;
+    }
+    void swap(heap &other) {
+      node* tmp = root;
+      root = other.root;
+      other.root = tmp;
+    }
+  };
+};
+
+/**
+ * lazy binomial heap: push and merge only splice root lists and compare
+ * against the cached top, O(1); pop links roots of equal degree until all
+ * degrees differ, O(logn) amortized. left is the first child, right the
+ * next sibling or the next root.
+ */
+class binomial_policy {
+public:
+  template<typename T, class Compare>
+  class heap {
+  public:
+    class node {
+    public:
+      node* left;
+      node* right;
+      int degree;
+      T content;
+      template<class... Args>
+      node(std::in_place_t, Args&&... args) : left(nullptr), right(nullptr), degree(0), content(std::forward<Args>(args)...) {}
+      node(const node &other) : left(nullptr), right(nullptr), degree(other.degree), content(other.content) {}
+    };
+
+  private:
+    node* head; // root list
+    node* tail;
+    node* best;
+
+  public:
+    heap() : head(nullptr), tail(nullptr), best(nullptr) {}
+    heap(const heap &) = delete;
+    heap &operator=(const heap &) = delete;
+
+    bool empty() const {
+      return head == nullptr;
+    }
+    node* top() const {
+      return best;
+    }
+    void push(node* n) {
+      bool above = best && Compare()(best->content, n->content);
+      add_root(n);
+      if(!best || above) best = n;
+    }
+    node* pop() {
+      node* ret = best;
+      // Unlink best, its children join the root list
+      node* list = nullptr;
+      node* last = nullptr;
+      for(node* p = head; p; ) {
+        node* nxt = p->right;
+        if(p != ret) append(list, last, p);
+        p = nxt;
+      }
+      for(node* p = ret->left; p; ) {
+        node* nxt = p->right;
+        append(list, last, p);
+        p = nxt;
+      }
+      node* bucket[sizeof(size_t) * CHAR_BIT + 1];
+      for(size_t d = 0; d < sizeof(bucket) / sizeof(node*); ++d) bucket[d] = nullptr;
+      node* carry = nullptr;
+      try {
+        while(list) {
+          carry = list;
+          list = list->right;
+          carry->right = nullptr;
+          while(bucket[carry->degree]) {
+            node* other = bucket[carry->degree];
+            if(Compare()(carry->content, other->content)) {
+              node* t = carry;
+              carry = other;
+              other = t;
+            }
+            bucket[carry->degree] = nullptr;
+            other->right = carry->left;
+            carry->left = other;
+            ++carry->degree;
+          }
+          bucket[carry->degree] = carry;
+          carry = nullptr;
+        }
+      }
+      catch(...) { // ret is still the largest, keep it as a single root
+        restore(ret, bucket, carry, list);
+        throw;
+      }
+      head = tail = nullptr;
+      node* nbest = nullptr;
+      try {
+        for(size_t d = 0; d < sizeof(bucket) / sizeof(node*); ++d) {
+          if(!bucket[d]) continue;
+          if(!nbest || Compare()(nbest->content, bucket[d]->content)) nbest = bucket[d];
+        }
+      }
+      catch(...) {
+        restore(ret, bucket, nullptr, nullptr);
+        throw;
+      }
+      for(size_t d = 0; d < sizeof(bucket) / sizeof(node*); ++d) {
+        if(bucket[d]) append(head, tail, bucket[d]);
+      }
+      best = nbest;
+      ret->left = ret->right = nullptr;
+      ret->degree = 0;
+      return ret;
+    }
+    /**
+     * pop, then the node goes back in with val. The old top is larger
+     * than all the rest, so if Compare throws it is put back as the top
+     * without comparing.
+     */
+    void replace_top(T &val) {
+      node* ret = pop();
+      bool above;
+      try {
+        above = !best || Compare()(best->content, val);
+      }
+      catch(...) {
+        add_root(ret);
+        best = ret;
+        throw;
+      }
+      ret->content = std::move(val);
+      add_root(ret);
+      if(above) best = ret;
+    }
+    void merge(heap &other) {
+      if(!other.head) return;
+      if(head) {
+        bool above = Compare()(best->content, other.best->content);
+        tail->right = other.head;
+        tail = other.tail;
+        if(above) best = other.best;
+      }
+      else {
+        head = other.head, tail = other.tail, best = other.best;
+      }
+      other.head = other.tail = other.best = nullptr;
+    }
+    // Every node becomes a root of degree 0, only the top is searched for
+    template<class Drop>
+    void build(node** nodes, size_t n, Drop drop) {
+      if(!n) return;
+      size_t k = 0;
+      try {
+        for(k = 1; k < n; ++k) {
+          if(Compare()(nodes[0]->content, nodes[k]->content)) {
+            node* t = nodes[0];
+            nodes[0] = nodes[k];
+            nodes[k] = t;
+          }
+        }
+      }
+      catch(...) {
+        for(k = 0; k < n; ++k) drop(nodes[k]);
+        throw;
+      }
+      for(k = 0; k < n; ++k) append(head, tail, nodes[k]);
+      best = head;
+    }
+    template<class Make, class Drop>
+    void copy_from(const heap &other, Make make, Drop drop) {
+      head = heap_tree::copy(other.head, make, drop);
+      tail = best = nullptr;
+      // The roots are copied in the same order, locate tail and best again
+      for(node *p = head, *q = other.head; p; p = p->right, q = q->right) {
+        if(q == other.best) best = p;
+        tail = p;
+      }
+    }
+    template<class Drop>
+    void clear(Drop drop) {
+      heap_tree::destroy(head, drop);
+      head = tail = best = nullptr;
+    }
+    void swap(heap &other) {
+      node* t;
+      t = head, head = other.head, other.head = t;
+      t = tail, tail = other.tail, other.tail = t;
+      t = best, best = other.best, other.best = t;
+    }
+
+  private:
+    void add_root(node* n) {
+      n->right = head;
+      head = n;
+      if(!tail) tail = n;
+    }
+    static void append(node* &first, node* &last, node* p) {
+      p->right = nullptr;
+      if(last) last->right = p;
+      else first = p;
+      last = p;
+    }
+    // Rebuild the root list from every piece of an interrupted pop
+    void restore(node* top, node** bucket, node* carry, node* list) {
+      head = tail = nullptr;
+      top->left = nullptr;
+      top->degree = 0;
+      append(head, tail, top);
+      for(size_t d = 0; d < sizeof(size_t) * CHAR_BIT + 1; ++d) {
+        if(bucket[d] && bucket[d] != carry) append(head, tail, bucket[d]);
+      }
+      if(carry) append(head, tail, carry);
+      while(list) {
+        node* nxt = list->right;
+        append(head, tail, list);
+        list = nxt;
+      }
+      best = top;
+    }
+  };
+};
+
+}
+
+#endif
@@ -0,0 +1,246 @@
+#ifndef SJTU_INDEXED_DARY_HEAP_HPP
+#define SJTU_INDEXED_DARY_HEAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <utility>
+#include "exceptions.hpp"
+
+namespace sjtu {
+/**
+ * a d-ary heap over the integer ids [0, n), each with a priority T.
+ * Next to the heap of ids there is a position array, so an element is
+ * found by its id: contains, priority: O(1); push, pop, update, erase:
+ * O(logn). All arrays are allocated by the constructor, no operation
+ * allocates afterwards.
+ *
+ * Only ids move inside the heap. Every operation first finds the final
+ * position with comparisons only, so if Compare throws the heap is left
+ * unchanged.
+ */
+template<typename T, class Compare = std::less<T>, int D = 4>
+class indexed_dary_heap {
+  static_assert(D >= 2, "a heap node needs at least two children");
+private:
+  static constexpr size_t npos = SIZE_MAX; // position of an absent id
+
+  size_t n, siz;
+  size_t* heap; // ids, heap ordered by their priorities
+  size_t* pos;  // pos[id] is the index of id in heap
+  T* prio;      // prio[id] is constructed while id is contained
+
+public:
+  /**
+   * an empty heap for the ids [0, n).
+   */
+  explicit indexed_dary_heap(size_t n) : n(n), siz(0), heap(nullptr), pos(nullptr), prio(nullptr) {
+    try {
+      heap = alloc<size_t>(n);
+      pos = alloc<size_t>(n);
+      prio = alloc<T>(n);
+    }
+    catch(...) {
+      destroy();
+      throw;
+    }
+    for(size_t i = 0; i < n; ++i) pos[i] = npos;
+  }
+  indexed_dary_heap(const indexed_dary_heap &other) : indexed_dary_heap(other.n) {
+    for(; siz < other.siz; ++siz) {
+      size_t id = other.heap[siz];
+      new(prio + id) T(other.prio[id]);
+      heap[siz] = id;
+      pos[id] = siz;
+    }
+  }
+  ~indexed_dary_heap() {
+    destroy();
+  }
+  indexed_dary_heap &operator=(const indexed_dary_heap &other) {
+    if(this == &other) return *this;
+    indexed_dary_heap tmp(other);
+    swap(tmp);
+    return *this;
+  }
+  void swap(indexed_dary_heap &other) {
+    std::swap(n, other.n);
+    std::swap(siz, other.siz);
+    std::swap(heap, other.heap);
+    std::swap(pos, other.pos);
+    std::swap(prio, other.prio);
+  }
+  /**
+   * the priority of the top element.
+   * throw container_is_empty if empty() returns true;
+   */
+  const T & top() const {
+    if(empty()) throw container_is_empty();
+    return prio[heap[0]];
+  }
+  /**
+   * the id of the top element.
+   * throw container_is_empty if empty() returns true;
+   */
+  size_t top_id() const {
+    if(empty()) throw container_is_empty();
+    return heap[0];
+  }
+  bool contains(size_t id) const {
+    return id < n && pos[id] != npos;
+  }
+  /**
+   * throw index_out_of_bound if contains(id) returns false;
+   */
+  const T & priority(size_t id) const {
+    if(!contains(id)) throw index_out_of_bound();
+    return prio[id];
+  }
+  /**
+   * add id with priority p.
+   * throw index_out_of_bound if id >= n,
+   * throw runtime_error if id is already contained;
+   */
+  void push(size_t id, const T &p) {
+    if(id >= n) throw index_out_of_bound();
+    if(pos[id] != npos) throw runtime_error();
+    new(prio + id) T(p);
+    size_t hole;
+    try {
+      hole = plan_up(siz, prio[id]);
+    }
+    catch(...) {
+      prio[id].~T();
+      throw;
+    }
+    move_up(siz, hole);
+    place(hole, id);
+    ++siz;
+  }
+  /**
+   * delete the top element.
+   * throw container_is_empty if empty() returns true;
+   */
+  void pop() {
+    if(empty()) throw container_is_empty();
+    remove(0);
+  }
+  /**
+   * give id the priority p, moving it up or down.
+   * throw index_out_of_bound if contains(id) returns false;
+   */
+  void update(size_t id, const T &p) {
+    if(!contains(id)) throw index_out_of_bound();
+    size_t i = pos[id];
+    size_t path[sizeof(size_t) * 8];
+    int len = 0;
+    size_t hole = plan_up(i, p);
+    if(hole == i) len = plan_down(i, p, siz, path);
+    prio[id] = p;
+    if(hole != i) move_up(i, hole);
+    else hole = shift_up(i, path, len);
+    place(hole, id);
+  }
+  /**
+   * remove id from the heap.
+   * throw index_out_of_bound if contains(id) returns false;
+   */
+  void erase(size_t id) {
+    if(!contains(id)) throw index_out_of_bound();
+    remove(pos[id]);
+  }
+  size_t size() const {
+    return siz;
+  }
+  bool empty() const {
+    return siz == 0;
+  }
+  // The ids are [0, capacity())
+  size_t capacity() const {
+    return n;
+  }
+
+private:
+  template<class U>
+  static U* alloc(size_t k) {
+    U* p = (U*) malloc((k ? k : 1) * sizeof(U));
+    if(!p) throw std::bad_alloc();
+    return p;
+  }
+  void destroy() {
+    for(size_t i = 0; i < siz; ++i) {
+      prio[heap[i]].~T();
+    }
+    free(heap);
+    free(pos);
+    free(prio);
+  }
+  void place(size_t i, size_t id) {
+    heap[i] = id;
+    pos[id] = i;
+  }
+  // The slot val rises to from hole, with comparisons only
+  size_t plan_up(size_t hole, const T &val) const {
+    while(hole > 0 && Compare()(prio[heap[(hole - 1) / D]], val)) {
+      hole = (hole - 1) / D;
+    }
+    return hole;
+  }
+  // Move the ancestors of from down one level each, up to target
+  void move_up(size_t from, size_t target) {
+    for(size_t i = from; i != target; i = (i - 1) / D) {
+      place(i, heap[(i - 1) / D]);
+    }
+  }
+  /**
+   * find the children val has to pass when it sinks from hole within
+   * heap[0, k), with comparisons only.
+   */
+  int plan_down(size_t hole, const T &val, size_t k, size_t* path) const {
+    int len = 0;
+    while(true) {
+      size_t first = D * hole + 1;
+      if(first >= k) break;
+      size_t last = first + D < k ? first + D : k;
+      size_t best = first;
+      for(size_t c = first + 1; c < last; ++c) {
+        if(Compare()(prio[heap[best]], prio[heap[c]])) best = c;
+      }
+      if(!Compare()(val, prio[heap[best]])) break;
+      path[len++] = best;
+      hole = best;
+    }
+    return len;
+  }
+  // Move the children on path up one level each, return the freed slot
+  size_t shift_up(size_t hole, const size_t* path, int len) {
+    for(int k = 0; k < len; ++k) {
+      place(hole, heap[path[k]]);
+      hole = path[k];
+    }
+    return hole;
+  }
+  // The last id fills slot i, rising or sinking within heap[0, siz - 1)
+  void remove(size_t i) {
+    size_t id = heap[i], last = siz - 1;
+    if(i != last) {
+      size_t moved = heap[last];
+      size_t path[sizeof(size_t) * 8];
+      int len = 0;
+      size_t hole = plan_up(i, prio[moved]);
+      if(hole == i) len = plan_down(i, prio[moved], last, path);
+      if(hole != i) move_up(i, hole);
+      else hole = shift_up(i, path, len);
+      place(hole, moved);
+    }
+    prio[id].~T();
+    pos[id] = npos;
+    --siz;
+  }
+};
+
+}
+
+#endif
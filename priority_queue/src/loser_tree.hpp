@@ -0,0 +1,214 @@
+#ifndef SJTU_LOSER_TREE_HPP
+#define SJTU_LOSER_TREE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <utility>
+#include "exceptions.hpp"
+
+namespace sjtu {
+/**
+ * a k-way merger of sorted runs given as iterator pairs [first, last).
+ * Each run is sorted by Compare, as for std::merge, and the merged output
+ * is too; equal elements come out in the order of their runs.
+ *
+ * A tournament tree keeps at every inner node the run that lost the match
+ * there, the overall winner is the current top. Popping advances the
+ * winning run and replays only its leaf-to-root path: at most ceil(log2 k)
+ * comparisons per element. The constructor allocates the tree and the
+ * iterators; nothing allocates afterwards.
+ *
+ * If Compare throws, the merger is left unchanged (for forward iterators,
+ * whose copies can be used to step back).
+ */
+template<class InputIt, class Compare = std::less<typename std::iterator_traits<InputIt>::value_type>>
+class loser_tree {
+public:
+  typedef typename std::iterator_traits<InputIt>::value_type value_type;
+  typedef typename std::iterator_traits<InputIt>::reference reference;
+
+private:
+  size_t k;
+  InputIt* cur;  // the unmerged part of run i is [cur[i], end[i])
+  InputIt* end;
+  size_t* loser; // loser[t] for the inner nodes 1 ... k - 1, leaf of run i is k + i
+  size_t winner;
+
+public:
+  /**
+   * merge the runs of [first, last), a range of pairs of iterators.
+   */
+  template<class PairIt>
+  loser_tree(PairIt first, PairIt last) : k(0), cur(nullptr), end(nullptr), loser(nullptr), winner(0) {
+    for(PairIt it = first; it != last; ++it) ++k;
+    try {
+      cur = alloc<InputIt>(k);
+      end = alloc<InputIt>(k);
+      loser = alloc<size_t>(k);
+      size_t n = 0;
+      try {
+        for(; first != last; ++first, ++n) {
+          new(cur + n) InputIt((*first).first);
+          try {
+            new(end + n) InputIt((*first).second);
+          }
+          catch(...) {
+            cur[n].~InputIt();
+            throw;
+          }
+        }
+      }
+      catch(...) {
+        destroy_runs(n);
+        throw;
+      }
+    }
+    catch(...) {
+      free(cur);
+      free(end);
+      free(loser);
+      throw;
+    }
+    if(k) {
+      try {
+        winner = build(1);
+      }
+      catch(...) {
+        destroy();
+        throw;
+      }
+    }
+  }
+  loser_tree(const loser_tree &) = delete;
+  loser_tree &operator=(const loser_tree &) = delete;
+  ~loser_tree() {
+    destroy();
+  }
+
+  /**
+   * the smallest unmerged element.
+   * throw container_is_empty if empty() returns true;
+   */
+  reference top() const {
+    if(empty()) throw container_is_empty();
+    return *cur[winner];
+  }
+  // The index of the run top() comes from
+  size_t top_run() const {
+    if(empty()) throw container_is_empty();
+    return winner;
+  }
+  /**
+   * advance past top().
+   * throw container_is_empty if empty() returns true;
+   */
+  void pop() {
+    if(empty()) throw container_is_empty();
+    advance();
+  }
+  /**
+   * pop up to n elements, smallest first, appending them to out
+   * (e.g. a sjtu::vector) with push_back.
+   * An element is appended before the tree advances past it: if Compare
+   * throws, it is taken off out again with pop_back(), so it is neither
+   * lost nor returned twice.
+   * @return the number of elements popped.
+   */
+  template<class Container>
+  size_t pop_n(size_t n, Container &out) {
+    size_t m = 0;
+    for(; m < n && !empty(); ++m) {
+      out.push_back(*cur[winner]);
+      try {
+        advance();
+      }
+      catch(...) {
+        out.pop_back();
+        throw;
+      }
+    }
+    return m;
+  }
+  bool empty() const {
+    return k == 0 || cur[winner] == end[winner];
+  }
+  // The number of runs
+  size_t runs() const {
+    return k;
+  }
+
+private:
+  template<class U>
+  static U* alloc(size_t n) {
+    U* p = (U*) malloc((n ? n : 1) * sizeof(U));
+    if(!p) throw std::bad_alloc();
+    return p;
+  }
+  void destroy_runs(size_t n) {
+    for(size_t i = 0; i < n; ++i) {
+      cur[i].~InputIt();
+      end[i].~InputIt();
+    }
+  }
+  void destroy() {
+    destroy_runs(k);
+    free(cur);
+    free(end);
+    free(loser);
+  }
+  // Whether run a wins over run b: an exhausted run loses every match
+  bool beats(size_t a, size_t b) const {
+    if(cur[a] == end[a]) return false;
+    if(cur[b] == end[b]) return true;
+    if(a < b) return !Compare()(*cur[b], *cur[a]);
+    return Compare()(*cur[a], *cur[b]);
+  }
+  // Play the matches of the subtree at t, return its winner
+  size_t build(size_t t) {
+    if(t >= k) return t - k;
+    size_t a = build(2 * t), b = build(2 * t + 1);
+    if(beats(a, b)) {
+      loser[t] = b;
+      return a;
+    }
+    loser[t] = a;
+    return b;
+  }
+  /**
+   * step the winning run and replay its path. The matches are played
+   * first and only then written, so a throw leaves the tree as it was.
+   */
+  void advance() {
+    size_t w = winner;
+    InputIt old = cur[w];
+    ++cur[w];
+    uint64_t swaps = 0; // bit d: the stored loser wins at depth d of the path
+    int d = 0;
+    try {
+      size_t in_hand = w;
+      for(size_t t = (w + k) / 2; t > 0; t /= 2, ++d) {
+        if(beats(loser[t], in_hand)) {
+          swaps |= uint64_t(1) << d;
+          in_hand = loser[t];
+        }
+      }
+    }
+    catch(...) {
+      cur[w] = old;
+      throw;
+    }
+    d = 0;
+    for(size_t t = (w + k) / 2; t > 0; t /= 2, ++d) {
+      if(swaps >> d & 1) std::swap(loser[t], w);
+    }
+    winner = w;
+  }
+};
+
+}
+
+#endif
@@ -0,0 +1,224 @@
+#ifndef SJTU_MINMAX_HEAP_HPP
+#define SJTU_MINMAX_HEAP_HPP
+
+#include <bit>
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <utility>
+#include "exceptions.hpp"
+
+namespace sjtu {
+/**
+ * an array-backed min-max heap, a double-ended priority queue.
+ * Nodes on even levels (the root is level 0) are the smallest of their
+ * subtree, nodes on odd levels the largest, so min() is the root and
+ * max() one of its children.
+ * min, max: O(1); push, pop_min, pop_max: O(logn).
+ *
+ * An operation swaps elements while it compares them, so the swaps are
+ * journaled and undone if Compare throws: the heap is left unchanged.
+ */
+template<typename T, class Compare = std::less<T>>
+class minmax_heap {
+private:
+  size_t siz, capacity;
+  T* data;
+
+  // Swaps done by the running operation, undone in reverse on a throw
+  class journal {
+  public:
+    size_t a[2 * sizeof(size_t) * 8], b[2 * sizeof(size_t) * 8];
+    int len = 0;
+  };
+
+public:
+  minmax_heap() : siz(0), capacity(16) {
+    data = alloc(capacity);
+  }
+  minmax_heap(const minmax_heap &other) : siz(0), capacity(other.siz ? other.siz : 16) {
+    data = alloc(capacity);
+    try {
+      for(; siz < other.siz; ++siz) {
+        new(data + siz) T(other.data[siz]);
+      }
+    }
+    catch(...) {
+      destroy();
+      throw;
+    }
+  }
+  ~minmax_heap() {
+    destroy();
+  }
+  minmax_heap &operator=(const minmax_heap &other) {
+    if(this == &other) return *this;
+    minmax_heap tmp(other);
+    swap(tmp);
+    return *this;
+  }
+  void swap(minmax_heap &other) {
+    std::swap(siz, other.siz);
+    std::swap(capacity, other.capacity);
+    std::swap(data, other.data);
+  }
+  /**
+   * throw container_is_empty if empty() returns true;
+   */
+  const T & min() const {
+    if(empty()) throw container_is_empty();
+    return data[0];
+  }
+  const T & max() const {
+    if(empty()) throw container_is_empty();
+    return data[max_index()];
+  }
+
+  void push(const T &e) {
+    emplace(e);
+  }
+  void push(T &&e) {
+    emplace(std::move(e));
+  }
+  template<class... Args>
+  void emplace(Args&&... args) {
+    if(siz == capacity) expand();
+    new(data + siz) T(std::forward<Args>(args)...);
+    journal log;
+    try {
+      bubble_up(siz, log);
+    }
+    catch(...) {
+      undo(log);
+      data[siz].~T();
+      throw;
+    }
+    ++siz;
+  }
+  /**
+   * delete the smallest element.
+   * throw container_is_empty if empty() returns true;
+   */
+  void pop_min() {
+    if(empty()) throw container_is_empty();
+    remove(0);
+  }
+  /**
+   * delete the largest element.
+   * throw container_is_empty if empty() returns true;
+   */
+  void pop_max() {
+    if(empty()) throw container_is_empty();
+    remove(max_index());
+  }
+  size_t size() const {
+    return siz;
+  }
+  bool empty() const {
+    return siz == 0;
+  }
+
+private:
+  static T* alloc(size_t n) {
+    T* p = (T*) malloc(n * sizeof(T));
+    if(!p) throw std::bad_alloc();
+    return p;
+  }
+  void destroy() {
+    for(size_t i = 0; i < siz; ++i) {
+      data[i].~T();
+    }
+    free(data);
+  }
+  void expand() {
+    T* n_data = alloc(capacity * 2);
+    for(size_t i = 0; i < siz; ++i) {
+      new(n_data + i) T(std::move(data[i]));
+      data[i].~T();
+    }
+    free(data);
+    data = n_data;
+    capacity *= 2;
+  }
+  size_t max_index() const {
+    if(siz == 1) return 0;
+    if(siz == 2 || Compare()(data[2], data[1])) return 1;
+    return 2;
+  }
+  static bool on_min_level(size_t i) {
+    return (std::bit_width(i + 1) - 1) % 2 == 0;
+  }
+  // Whether a comes first on a level of the kind of i: smaller on min levels
+  bool before(const T &a, const T &b, bool min_level) const {
+    return min_level ? Compare()(a, b) : Compare()(b, a);
+  }
+  void exchange(size_t i, size_t j, journal &log) {
+    std::swap(data[i], data[j]);
+    log.a[log.len] = i;
+    log.b[log.len] = j;
+    ++log.len;
+  }
+  void undo(journal &log) {
+    while(log.len) {
+      --log.len;
+      std::swap(data[log.a[log.len]], data[log.b[log.len]]);
+    }
+  }
+  // The last element moves into i, which is then restored among data[0, siz - 1)
+  void remove(size_t i) {
+    size_t last = siz - 1;
+    if(i != last) {
+      journal log;
+      try {
+        exchange(i, last, log);
+        trickle_down(i, last, log);
+      }
+      catch(...) {
+        undo(log);
+        throw;
+      }
+    }
+    data[last].~T();
+    --siz;
+  }
+  void bubble_up(size_t i, journal &log) {
+    if(i == 0) return;
+    size_t parent = (i - 1) / 2;
+    bool min_level = on_min_level(i);
+    // A parent is of the other kind: if i beats it there, i belongs to that kind
+    if(before(data[parent], data[i], min_level)) {
+      exchange(i, parent, log);
+      i = parent;
+      min_level = !min_level;
+    }
+    while(i > 2) {
+      size_t grand = ((i - 1) / 2 - 1) / 2;
+      if(!before(data[i], data[grand], min_level)) break;
+      exchange(i, grand, log);
+      i = grand;
+    }
+  }
+  // Sink data[i] within data[0, n)
+  void trickle_down(size_t i, size_t n, journal &log) {
+    bool min_level = on_min_level(i);
+    while(2 * i + 1 < n) {
+      // The best of the children and grandchildren
+      size_t m = 2 * i + 1;
+      size_t candidates[5] = {2 * i + 2, 4 * i + 3, 4 * i + 4, 4 * i + 5, 4 * i + 6};
+      for(int k = 0; k < 5 && candidates[k] < n; ++k) {
+        if(before(data[candidates[k]], data[m], min_level)) m = candidates[k];
+      }
+      if(!before(data[m], data[i], min_level)) return;
+      exchange(m, i, log);
+      if(m <= 2 * i + 2) return; // beat no grandchild, so the child holds it fine
+      size_t parent = (m - 1) / 2;
+      if(before(data[parent], data[m], min_level)) exchange(m, parent, log);
+      i = m;
+    }
+  }
+};
+
+}
+
+#endif
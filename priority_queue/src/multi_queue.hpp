@@ -0,0 +1,125 @@
+#ifndef SJTU_MULTI_QUEUE_HPP
+#define SJTU_MULTI_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <utility>
+#include "dary_heap.hpp"
+
+namespace sjtu {
+/**
+ * a relaxed concurrent priority queue (MultiQueue).
+ * c * p heaps each have their own lock. push goes to a random heap and
+ * try_pop takes the better of the tops of two random heaps, so threads
+ * rarely wait on each other. In return try_pop does not always return
+ * the top: the element returned ranks among the top O(c * p) in expectation.
+ *
+ * Heap is any of dary_heap (default) or priority_queue over T and Compare.
+ * All members may be called concurrently, except construction and destruction.
+ */
+template<typename T, class Compare = std::less<T>, class Heap = dary_heap<T, Compare>>
+class multi_queue {
+private:
+  class alignas(64) slot { // one cache line each, so locks do not collide
+  public:
+    std::mutex lock;
+    Heap heap;
+  };
+
+  slot* slots;
+  size_t count;
+  std::atomic<size_t> siz;
+
+public:
+  /**
+   * threads: the number of threads expected to use the queue,
+   * c: heaps per thread, more heaps mean less waiting but a looser order.
+   */
+  explicit multi_queue(unsigned threads = std::thread::hardware_concurrency(), unsigned c = 2) : siz(0) {
+    if(!threads) threads = 1;
+    if(!c) c = 1;
+    count = size_t(threads) * c;
+    if(count < 2) count = 2; // try_pop picks two distinct heaps
+    slots = new slot[count];
+  }
+  multi_queue(const multi_queue &) = delete;
+  multi_queue &operator=(const multi_queue &) = delete;
+  ~multi_queue() {
+    delete[] slots;
+  }
+
+  void push(const T &e) {
+    emplace(e);
+  }
+  void push(T &&e) {
+    emplace(std::move(e));
+  }
+  template<class... Args>
+  void emplace(Args&&... args) {
+    // Skip heaps that are busy, block only when every try failed
+    size_t i = pick();
+    for(size_t tries = 0; !slots[i].lock.try_lock(); ++tries) {
+      if(tries == count) {
+        slots[i].lock.lock();
+        break;
+      }
+      i = pick();
+    }
+    std::lock_guard<std::mutex> hold(slots[i].lock, std::adopt_lock);
+    slots[i].heap.emplace(std::forward<Args>(args)...);
+    siz.fetch_add(1, std::memory_order_relaxed);
+  }
+  /**
+   * move an element close to the top into out.
+   * return false if every heap was found empty.
+   */
+  bool try_pop(T &out) {
+    for(size_t tries = 0; tries < count; ++tries) {
+      if(!siz.load(std::memory_order_relaxed)) return false;
+      size_t i = pick(), j = pick();
+      if(i == j) j = (j + 1) % count;
+      std::scoped_lock hold(slots[i].lock, slots[j].lock);
+      Heap* a = &slots[i].heap;
+      Heap* b = &slots[j].heap;
+      if(a->empty() || (!b->empty() && Compare()(a->top(), b->top()))) {
+        a = b;
+      }
+      if(a->empty()) continue;
+      out = a->pop_value();
+      siz.fetch_sub(1, std::memory_order_relaxed);
+      return true;
+    }
+    // Few elements left: look through every heap before giving up
+    for(size_t i = 0; i < count; ++i) {
+      std::lock_guard<std::mutex> hold(slots[i].lock);
+      if(slots[i].heap.empty()) continue;
+      out = slots[i].heap.pop_value();
+      siz.fetch_sub(1, std::memory_order_relaxed);
+      return true;
+    }
+    return false;
+  }
+  /**
+   * only a snapshot while other threads push or pop.
+   */
+  size_t size() const {
+    return siz.load(std::memory_order_relaxed);
+  }
+  bool empty() const {
+    return size() == 0;
+  }
+
+private:
+  size_t pick() const {
+    thread_local std::minstd_rand rng(std::random_device{}());
+    return rng() % count;
+  }
+};
+
+}
+
+#endif
@@ -0,0 +1,139 @@
+#ifndef SJTU_NODE_POOL_HPP
+#define SJTU_NODE_POOL_HPP
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace sjtu {
+/**
+ * a slab allocator handing out raw storage for Node.
+ * Slots are carved from blocks of growing size and recycled through a
+ * free-list; the blocks themselves are only freed when the pool dies.
+ *
+ * Pools are reference counted and can be united in O(1): the blocks and
+ * free-list of one are spliced into the other, which it then forwards to.
+ * Containers whose nodes get mixed (e.g. by merge) unite their pools,
+ * so every node still belongs to a live pool.
+ */
+template<class Node>
+class node_pool {
+private:
+  union slot {
+    slot* next;
+    alignas(Node) unsigned char buf[sizeof(Node)];
+  };
+  static constexpr size_t min_block = 32;
+  static constexpr size_t max_block = 1 << 16;
+
+  size_t refs;
+  node_pool* forward; // set once spliced into another pool
+  slot* blocks;       // slot 0 of every block links to the next block
+  slot* last_block;
+  slot* free_head;
+  slot* free_tail;
+  slot* cur;          // untouched part of the newest block
+  slot* end;
+  size_t next_size;
+
+  node_pool() : refs(1), forward(nullptr), blocks(nullptr), last_block(nullptr),
+                free_head(nullptr), free_tail(nullptr), cur(nullptr), end(nullptr),
+                next_size(min_block) {}
+  ~node_pool() {
+    while(blocks) {
+      slot* nxt = blocks->next;
+      free(blocks);
+      blocks = nxt;
+    }
+  }
+
+public:
+  node_pool(const node_pool &) = delete;
+  node_pool &operator=(const node_pool &) = delete;
+
+  static node_pool* create() {
+    return new node_pool;
+  }
+  static void retain(node_pool* p) {
+    ++p->refs;
+  }
+  static void release(node_pool* p) {
+    if(--p->refs) return;
+    if(p->forward) release(p->forward);
+    delete p;
+  }
+  // The pool that currently owns the storage of p
+  static node_pool* find(node_pool* p) {
+    while(p->forward) p = p->forward;
+    return p;
+  }
+  /**
+   * merge the storage of b into a, O(1).
+   * The unused tail of b's newest block is given up.
+   */
+  static void unite(node_pool* a, node_pool* b) {
+    a = find(a), b = find(b);
+    if(a == b) return;
+    if(b->blocks) {
+      if(a->blocks) a->last_block->next = b->blocks;
+      else a->blocks = b->blocks;
+      a->last_block = b->last_block;
+    }
+    if(b->free_head) {
+      if(a->free_head) a->free_tail->next = b->free_head;
+      else a->free_head = b->free_head;
+      a->free_tail = b->free_tail;
+    }
+    b->blocks = b->last_block = nullptr;
+    b->free_head = b->free_tail = nullptr;
+    b->cur = b->end = nullptr;
+    b->forward = a;
+    retain(a);
+  }
+  // only meaningful on a pool returned by find
+  bool unique() const {
+    return refs == 1;
+  }
+
+  void* allocate() {
+    if(free_head) {
+      slot* s = free_head;
+      free_head = s->next;
+      if(!free_head) free_tail = nullptr;
+      return s;
+    }
+    if(cur == end) grow(next_size);
+    return cur++;
+  }
+  /**
+   * make the next n allocations that miss the free-list come from one
+   * untouched run of slots, so nodes built together sit together.
+   */
+  void reserve(size_t n) {
+    if(size_t(end - cur) < n) grow(n > next_size ? n : next_size);
+  }
+  void deallocate(void* p) {
+    slot* s = static_cast<slot*>(p);
+    s->next = free_head;
+    if(!free_head) free_tail = s;
+    free_head = s;
+  }
+
+private:
+  // The unused tail of the previous block is given up
+  void grow(size_t n) {
+    slot* b = (slot*) malloc((n + 1) * sizeof(slot));
+    if(!b) throw std::bad_alloc();
+    b->next = nullptr;
+    if(last_block) last_block->next = b;
+    else blocks = b;
+    last_block = b;
+    cur = b + 1;
+    end = b + 1 + n;
+    if(next_size < max_block) next_size *= 2;
+  }
+};
+
+}
+
+#endif
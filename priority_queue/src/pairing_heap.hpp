@@ -0,0 +1,330 @@
+#ifndef SJTU_PAIRING_HEAP_HPP
+#define SJTU_PAIRING_HEAP_HPP
+
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include "exceptions.hpp"
+#include "heap_policy.hpp"
+#include "node_pool.hpp"
+
+namespace sjtu {
+/**
+ * an addressable pairing heap.
+ * push returns a handle that stays valid until its element is popped or
+ * erased (also after the heap is merged into another one), through which
+ * the element can be re-prioritized or removed.
+ *
+ * push, merge, top: O(1); pop, erase: O(logn) amortized (two-pass);
+ * decrease_key: O(1) plus a cut, increase_key: O(logn) amortized.
+ * The pairing itself is pairing_tree of heap_policy.hpp, which also
+ * backs pairing_policy.
+ * decrease_key moves an element toward the top, increase_key away from
+ * it; with the default std::less the top is the largest value, so
+ * decrease_key needs a larger value.
+ *
+ * If Compare throws, the heap keeps all its elements and stays valid.
+ */
+template<typename T, class Compare = std::less<T>>
+class pairing_heap {
+private:
+  class node {
+  public:
+    node* left;  // first child
+    node* right; // next sibling
+    node* prev;  // parent for the first child, left sibling otherwise
+    T content;
+    node(const T &con) : left(nullptr), right(nullptr), prev(nullptr), content(con) {}
+  };
+  typedef node_pool<node> pool_type;
+  typedef pairing_tree<node, Compare> tree;
+
+  size_t siz;
+  node* root;
+  pool_type* mem;
+
+public:
+  class handle {
+    friend class pairing_heap;
+  private:
+    node* p;
+    handle(node* _p) : p(_p) {}
+  public:
+    handle() : p(nullptr) {}
+    bool operator==(const handle &rhs) const { return p == rhs.p; }
+    bool operator!=(const handle &rhs) const { return p != rhs.p; }
+  };
+
+  pairing_heap() : siz(0), root(nullptr), mem(nullptr) {}
+  /**
+   * handles of other do not refer to the copy.
+   */
+  pairing_heap(const pairing_heap &other) : siz(0), root(nullptr), mem(nullptr) {
+    try {
+      root = copy(other.root);
+    }
+    catch(...) {
+      if(mem) pool_type::release(mem);
+      throw;
+    }
+    siz = other.siz;
+  }
+  ~pairing_heap() {
+    destroy(root);
+    if(mem) pool_type::release(mem);
+  }
+  pairing_heap &operator=(const pairing_heap &other) {
+    if(this == &other) return *this;
+    node* fresh = copy(other.root);
+    destroy(root);
+    root = fresh;
+    siz = other.siz;
+    return *this;
+  }
+
+  /**
+   * throw container_is_empty if empty() returns true;
+   */
+  const T & top() const {
+    if(empty()) throw container_is_empty();
+    return root->content;
+  }
+  const T & get(const handle &h) const {
+    return h.p->content;
+  }
+  size_t size() const {
+    return siz;
+  }
+  bool empty() const {
+    return root == nullptr;
+  }
+
+  handle push(const T &e) {
+    node* add = make_node(e);
+    try {
+      root = tree::meld(root, add);
+    }
+    catch(...) {
+      drop_node(add);
+      throw;
+    }
+    ++siz;
+    return handle(add);
+  }
+  /**
+   * delete the top element.
+   * throw container_is_empty if empty() returns true;
+   */
+  void pop() {
+    if(empty()) throw container_is_empty();
+    tree::combine(root);
+    node* old = root;
+    root = old->left;
+    if(root) root->prev = nullptr;
+    --siz;
+    drop_node(old);
+  }
+  /**
+   * meld other into this in O(1) and clear other.
+   * Handles of other now refer to elements of this. other gets a pool
+   * of its own on its next push, it shares no allocator state with this.
+   */
+  void merge(pairing_heap &other) {
+    if(this == &other) return;
+    if(other.mem) {
+      if(!mem) {
+        mem = other.mem;
+        pool_type::retain(mem);
+      }
+      else {
+        pool_type::unite(mem, other.mem);
+      }
+    }
+    root = tree::meld(root, other.root);
+    siz += other.siz;
+    other.siz = 0;
+    other.root = nullptr;
+    if(other.mem) {
+      pool_type::release(other.mem);
+      other.mem = nullptr;
+    }
+  }
+  /**
+   * give the element of h the value v, which ranks at least as high
+   * as its current value: O(1) plus a cut.
+   * throw runtime_error if v ranks lower, the heap is unchanged;
+   */
+  void decrease_key(const handle &h, const T &v) {
+    node* p = h.p;
+    if(Compare()(v, p->content)) throw runtime_error();
+    raise(p, v);
+  }
+  /**
+   * give the element of h the value v, which ranks at most as high
+   * as its current value: a combine of its children.
+   * throw runtime_error if v ranks higher, the heap is unchanged;
+   */
+  void increase_key(const handle &h, const T &v) {
+    node* p = h.p;
+    if(Compare()(p->content, v)) throw runtime_error();
+    sink(p, v);
+  }
+  /**
+   * give the element of h the value v, moving it up or down.
+   */
+  void update(const handle &h, const T &v) {
+    node* p = h.p;
+    if(Compare()(v, p->content)) sink(p, v);
+    else raise(p, v);
+  }
+  /**
+   * remove the element of h, invalidating h.
+   */
+  void erase(const handle &h) {
+    node* p = h.p;
+    if(p == root) {
+      pop();
+      return;
+    }
+    tree::combine(p);
+    cut(p);
+    node* c = p->left;
+    if(c) { // Everything below p ranks below root
+      c->prev = nullptr;
+      tree::link(root, c);
+    }
+    --siz;
+    drop_node(p);
+  }
+
+private:
+  pool_type* pool() {
+    if(!mem) {
+      mem = pool_type::create();
+    }
+    else {
+      pool_type* owner = pool_type::find(mem);
+      if(owner != mem) {
+        pool_type::retain(owner);
+        pool_type::release(mem);
+        mem = owner;
+      }
+    }
+    return mem;
+  }
+  node* make_node(const T &con) {
+    void* raw = pool()->allocate();
+    try {
+      return new(raw) node(con);
+    }
+    catch(...) {
+      mem->deallocate(raw);
+      throw;
+    }
+  }
+  void drop_node(node* p) {
+    p->~node();
+    pool()->deallocate(p);
+  }
+
+  // Detach the subtree of p (not the root) from its parent
+  static void cut(node* p) {
+    if(p->prev->left == p) p->prev->left = p->right;
+    else p->prev->right = p->right;
+    if(p->right) p->right->prev = p->prev;
+    p->prev = p->right = nullptr;
+  }
+  // p gets a value ranking at least as high
+  void raise(node* p, const T &v) {
+    if(p == root) {
+      p->content = v;
+      return;
+    }
+    bool above = Compare()(root->content, v);
+    p->content = v;
+    cut(p);
+    if(above) {
+      tree::link(p, root);
+      root = p;
+    }
+    else {
+      tree::link(root, p);
+    }
+  }
+  // p gets a value ranking lower
+  void sink(node* p, const T &v) {
+    tree::combine(p);
+    node* c = p->left;
+    if(p == root) {
+      bool down = c && Compare()(v, c->content);
+      p->content = v;
+      if(down) {
+        p->left = nullptr;
+        c->prev = nullptr;
+        tree::link(c, p);
+        root = c;
+      }
+      return;
+    }
+    // Both c and p with its new value rank below root
+    p->content = v;
+    cut(p);
+    if(c) {
+      p->left = nullptr;
+      c->prev = nullptr;
+      tree::link(root, c);
+    }
+    tree::link(root, p);
+  }
+
+  /**
+   * copy other in preorder of the left/right tree with a worklist.
+   * If anything throws, the partial copy is destroyed.
+   */
+  node* copy(node* other) {
+    if(!other) return nullptr;
+    class task {
+    public:
+      node* src;
+      node* up;   // prev of the copy
+      node** dst;
+    };
+    size_t cap = 64, top = 0;
+    task* work = (task*) malloc(cap * sizeof(task));
+    if(!work) throw std::bad_alloc();
+    node* ret = nullptr;
+    work[top++] = task{other, nullptr, &ret};
+    try {
+      while(top) {
+        task t = work[--top];
+        node* cur = make_node(t.src->content);
+        cur->prev = t.up;
+        *t.dst = cur;
+        if(top + 2 > cap) {
+          task* bigger = (task*) realloc(work, cap * 2 * sizeof(task));
+          if(!bigger) throw std::bad_alloc();
+          work = bigger;
+          cap *= 2;
+        }
+        if(t.src->right) work[top++] = task{t.src->right, cur, &cur->right};
+        if(t.src->left) work[top++] = task{t.src->left, cur, &cur->left};
+      }
+    }
+    catch(...) {
+      free(work);
+      destroy(ret);
+      throw;
+    }
+    free(work);
+    return ret;
+  }
+  void destroy(node* p) {
+    auto drop = [this] (node* q) { drop_node(q); };
+    heap_tree::destroy(p, drop);
+  }
+};
+
+}
+
+#endif
@@ -0,0 +1,167 @@
+#ifndef SJTU_PERSISTENT_PRIORITY_QUEUE_HPP
+#define SJTU_PERSISTENT_PRIORITY_QUEUE_HPP
+
+#include <climits>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include "exceptions.hpp"
+
+namespace sjtu {
+/**
+ * an immutable leftist heap, every modification returns a new version.
+ * Only the nodes on the merge path are copied, all other subtrees are
+ * shared between versions through reference counts.
+ * push, pop and merge are O(logn), copying a version is O(1).
+ * Versions may not be shared across threads, the reference counts are plain.
+ */
+template<typename T, class Compare = std::less<T>>
+class persistent_priority_queue {
+private:
+  class node {
+  public:
+    union {
+      size_t refs;
+      node* next; // links dead nodes while releasing
+    };
+    node* left;
+    node* right;
+    int depth;
+    T content;
+    node(const T &con) : refs(1), left(nullptr), right(nullptr), depth(0), content(con) {}
+  };
+
+  node* root;
+  size_t siz;
+
+  persistent_priority_queue(node* r, size_t s) : root(r), siz(s) {}
+
+public:
+  persistent_priority_queue() : root(nullptr), siz(0) {}
+  persistent_priority_queue(const persistent_priority_queue &other) : root(other.root), siz(other.siz) {
+    if(root) ++root->refs;
+  }
+  ~persistent_priority_queue() {
+    if(root) release(root);
+  }
+  persistent_priority_queue &operator=(const persistent_priority_queue &other) {
+    if(this == &other) return *this;
+    if(other.root) ++other.root->refs;
+    if(root) release(root);
+    root = other.root, siz = other.siz;
+    return *this;
+  }
+
+  /**
+   * get the top of the queue.
+   * throw container_is_empty if empty() returns true;
+   */
+  const T & top() const {
+    if(empty()) throw container_is_empty();
+    return root->content;
+  }
+  size_t size() const {
+    return siz;
+  }
+  bool empty() const {
+    return root == nullptr;
+  }
+
+  persistent_priority_queue push(const T &e) const {
+    node* add = new node(e);
+    node* r;
+    try {
+      r = meld(root, add);
+    }
+    catch(...) {
+      release(add);
+      throw;
+    }
+    release(add);
+    return persistent_priority_queue(r, siz + 1);
+  }
+  /**
+   * delete the top element.
+   * throw container_is_empty if empty() returns true;
+   */
+  persistent_priority_queue pop() const {
+    if(empty()) throw container_is_empty();
+    return persistent_priority_queue(meld(root->left, root->right), siz - 1);
+  }
+  /**
+   * a version holding the elements of both, neither is changed.
+   */
+  persistent_priority_queue merge(const persistent_priority_queue &other) const {
+    return persistent_priority_queue(meld(root, other.root), siz + other.siz);
+  }
+
+private:
+  static int dep(node* p) {
+    if(p) return p->depth;
+    return -1;
+  }
+  // Free p if this was its last reference, then the children it held
+  static void release(node* p) {
+    if(--p->refs) return;
+    p->next = nullptr;
+    node* dead = p;
+    while(dead) {
+      node* n = dead;
+      dead = n->next;
+      node* kids[2] = {n->left, n->right};
+      delete n;
+      for(node* c : kids) {
+        if(c && !--c->refs) {
+          c->next = dead;
+          dead = c;
+        }
+      }
+    }
+  }
+  /**
+   * the leftist fuse of priority_queue, copying the path instead of
+   * relinking it. Compare is only called before anything is allocated,
+   * and a failed copy releases the part already built.
+   */
+  static node* meld(node* x, node* y) {
+    // Both right spines hold at most log2(n + 1) nodes each
+    node* path[2 * sizeof(size_t) * CHAR_BIT];
+    int len = 0;
+    while(x && y) {
+      if(Compare()(x->content, y->content)) {
+        node* t = x;
+        x = y;
+        y = t;
+      }
+      path[len++] = x;
+      x = x->right;
+    }
+    node* cur = x ? x : y;
+    if(cur) ++cur->refs;
+    try {
+      while(len) {
+        node* p = path[--len];
+        node* c = new node(p->content);
+        c->left = p->left;
+        if(c->left) ++c->left->refs;
+        c->right = cur;
+        if(dep(c->left) < dep(c->right)) {
+          node* t = c->left;
+          c->left = c->right;
+          c->right = t;
+        }
+        c->depth = dep(c->right) + 1;
+        cur = c;
+      }
+    }
+    catch(...) {
+      if(cur) release(cur);
+      throw;
+    }
+    return cur;
+  }
+};
+
+}
+
+#endif
@@ -2,53 +2,88 @@
 #define SJTU_PRIORITY_QUEUE_HPP
 
 #include <cstddef>
+#include <cstdlib>
 #include <functional>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
 #include "exceptions.hpp"
+#include "heap_policy.hpp"
+#include "node_pool.hpp"
 
 namespace sjtu {
-template<typename T, class Compare = std::less<T>>
+/**
+ * a meldable priority queue, the top is the largest element under Compare.
+ * Policy selects the heap algorithm, see heap_policy.hpp:
+ * leftist_policy (default), skew_policy, pairing_policy or binomial_policy.
+ */
+template<typename T, class Compare = std::less<T>, class Policy = leftist_policy>
 class priority_queue {
 private:
-  class node {
-  public:
-    node* left;
-    node* right;
-    T* content;
-    int depth;
-    node() = delete;
-    node(const T &con, int d = 0) : depth(d) {
-      content = new T(con);
-      left = nullptr;
-      right = nullptr;
-    }
-    ~node() {
-      delete content;
-    }
-  };
+  typedef typename Policy::template heap<T, Compare> core_type;
+  // The value lives inside the node: one allocation per push
+  // and no extra indirection when the heap compares two nodes.
+  typedef typename core_type::node node;
+  typedef node_pool<node> pool_type;
 
   int siz;
-  node* root;
+  core_type core;
+  pool_type* mem; // created on the first allocation
   //static Compare cmp;
 
 public:
   priority_queue() {
     siz = 0;
-    root = nullptr;
+    mem = nullptr;
   }
 
   priority_queue(const priority_queue &other) {
-    root = copy(other.root);
+    siz = 0;
+    mem = nullptr;
+    try {
+      copy(core, other.core);
+    }
+    catch(...) {
+      if(mem) pool_type::release(mem);
+      throw;
+    }
     siz = other.siz;
   }
 
+  /**
+   * build the queue from [first, last) in O(n): the nodes are allocated
+   * next to each other and then melded pairwise.
+   */
+  template<class InputIt>
+  priority_queue(InputIt first, InputIt last) {
+    siz = 0;
+    mem = nullptr;
+    try {
+      siz = build(core, first, last);
+    }
+    catch(...) {
+      if(mem) pool_type::release(mem);
+      throw;
+    }
+  }
+
   ~priority_queue() {
-    destroy(root);
+    if(!mem) return;
+    // A pool nobody else uses is freed block by block, no need to visit
+    // the nodes unless T has something to destruct.
+    if(!std::is_trivially_destructible<T>::value || !pool()->unique()) {
+      destroy(core);
+    }
+    pool_type::release(mem);
   }
 
   priority_queue &operator=(const priority_queue &other) {
     if(this == &other) return *this;
-    destroy(root);
-    root = copy(other.root);
+    core_type fresh;
+    copy(fresh, other.core); // keep the old content if copying throws
+    destroy(core);
+    core.swap(fresh);
     siz = other.siz;
     return *this;
   }
@@ -59,27 +94,110 @@ public:
    */
   const T & top() const {
     if(empty()) throw container_is_empty();
-    return *(root->content);
+    return core.top()->content;
   }
 
   void push(const T &e) {
-    node *add = new node(e);
+    link(make_node(std::in_place, e));
+  }
+
+  void push(T &&e) {
+    link(make_node(std::in_place, std::move(e)));
+  }
+  /**
+   * construct the element in place from args.
+   */
+  template<class... Args>
+  void emplace(Args&&... args) {
+    link(make_node(std::in_place, std::forward<Args>(args)...));
+  }
+
+  /**
+   * push every element of [first, last): they are built into a heap of
+   * their own in O(k), which is then merged in. Nothing is pushed if
+   * anything throws.
+   */
+  template<class InputIt>
+  void push_range(InputIt first, InputIt last) {
+    core_type fresh;
+    int n = build(fresh, first, last);
     try {
-      root = fuse(root, add);
+      core.merge(fresh);
     }
-    catch(...) { // Avoid memleak lest the comparison failed
-      delete add;
+    catch(...) {
+      destroy(fresh);
       throw;
     }
-    ++siz;
+    siz += n;
   }
 
   void pop() {
     if(empty()) throw container_is_empty();
+    node* temp = core.pop();
+    --siz;
+    drop_node(temp);
+  }
+
+  /**
+   * delete the top element and return it, moved out of the queue.
+   * throw container_is_empty if empty() returns true;
+   * If T's move constructor throws, the element is lost.
+   */
+  T pop_value() {
+    if(empty()) throw container_is_empty();
+    class guard {
+    public:
+      priority_queue* q;
+      node* p;
+      ~guard() { q->drop_node(p); }
+    } temp{this, core.pop()};
     --siz;
-    node* temp = root;
-    root = fuse(root->left, root->right);
-    delete temp;
+    return std::move(temp.p->content); // built before temp drops the node
+  }
+
+  /**
+   * replace the top element by e, the same as pop() then push(e), but in
+   * one pass from the top, which keeps its node. If e still beats the
+   * children of the top, it is just written over the top.
+   * throw container_is_empty if empty() returns true;
+   * If Compare throws, the queue is unchanged.
+   */
+  void replace_top(const T &e) {
+    if(empty()) throw container_is_empty();
+    T val(e);
+    core.replace_top(val);
+  }
+  void replace_top(T &&e) {
+    if(empty()) throw container_is_empty();
+    T val(std::move(e));
+    core.replace_top(val);
+  }
+  /**
+   * pop up to k elements, largest first, appending them to out
+   * (e.g. a sjtu::vector) with push_back.
+   * An element is appended before it is unlinked: if the pop throws, it
+   * is moved back with back() and pop_back(), so nothing is lost.
+   * @return the number of elements popped.
+   */
+  template<class Container>
+  size_t pop_n(size_t k, Container &out) {
+    size_t n = 0;
+    for(; n < k && !empty(); ++n) {
+      T &top = core.top()->content;
+      out.push_back(std::move(top));
+      node* p;
+      try {
+        p = core.pop();
+      }
+      catch(...) {
+        top = std::move(out.back());
+        out.pop_back();
+        throw;
+      }
+      --siz;
+      drop_node(p);
+    }
+    return n;
   }
 
   size_t size() const {
@@ -87,60 +205,126 @@ public:
   }
 
   bool empty() const {
-    if(root) return false;
-    return true;
+    return core.empty();
   }
   /**
    * merge two priority_queues with at most O(logn) complexity.
-   * clear the other priority_queue.
+   * clear the other priority_queue, which then gets a pool of its own
+   * on its next push and no longer shares allocator state with this.
    */
   void merge(priority_queue &other) {
-    root = fuse(root, other.root);
+    if(this == &other) return;
+    share_pool(other);
+    core.merge(other.core);
     siz += other.siz;
     other.siz = 0;
-    other.root = nullptr;
+    pool_type::release(other.mem);
+    other.mem = nullptr;
+  }
+  /**
+   * let this and other allocate from one node pool in O(1).
+   * merge does this implicitly, so nodes never outlive their pool.
+   */
+  void share_pool(priority_queue &other) {
+    if(this == &other) return;
+    if(!other.mem) {
+      other.mem = pool();
+      pool_type::retain(other.mem);
+    }
+    else if(!mem) {
+      mem = other.pool();
+      pool_type::retain(mem);
+    }
+    else {
+      pool_type::unite(mem, other.mem);
+    }
   }
 
 private:
-  int dep(node* p) const {
-    if(p) return p->depth;
-    return -1;
-  }
-  void exchange(node* &x, node* &y) {
-    node* temp = x;
-    x = y;
-    y = temp;
-  }
-  node* copy(node* other) {
-    if(!other) return nullptr;
-    node* cur = new node(*(other->content), other->depth);
-    cur->left = copy(other->left);
-    cur->right = copy(other->right);
-    return cur;
-  }
-  void destroy(node* p) {
-    if(!p) return;
-    destroy(p->left);
-    destroy(p->right);
-    delete p;
-    return;
+  pool_type* pool() {
+    if(!mem) {
+      mem = pool_type::create();
+    }
+    else {
+      pool_type* owner = pool_type::find(mem);
+      if(owner != mem) { // Skip the forwarding next time
+        pool_type::retain(owner);
+        pool_type::release(mem);
+        mem = owner;
+      }
+    }
+    return mem;
   }
-  /**
-   * fuse invalidate original relations.
-   */
-  node* fuse(node* x, node* y) {
-    if(!x) return y;
-    if(!y) return x;
-    if(Compare()(*(x->content), *(y->content))) {
-      exchange(x, y);
-    }
-    // x is the new root
-    x->right = fuse(x->right, y);
-    if(dep(x->left) < dep(x->right)) {
-      exchange(x->left, x->right);
-    }
-    x->depth = dep(x->right) + 1;
-    return x;
+  template<class... Args>
+  node* make_node(Args&&... args) {
+    void* raw = pool()->allocate();
+    try {
+      return new(raw) node(std::forward<Args>(args)...);
+    }
+    catch(...) {
+      mem->deallocate(raw);
+      throw;
+    }
+  }
+  void drop_node(node* p) {
+    p->~node();
+    pool()->deallocate(p);
+  }
+  void link(node* add) {
+    try {
+      core.push(add);
+    }
+    catch(...) { // Avoid memleak lest the comparison failed
+      drop_node(add);
+      throw;
+    }
+    ++siz;
+  }
+  void copy(core_type &dst, const core_type &src) {
+    dst.copy_from(src,
+                  [this] (const node &n) { return make_node(n); },
+                  [this] (node* p) { drop_node(p); });
+  }
+  template<class InputIt>
+  int build(core_type &dst, InputIt first, InputIt last) {
+    size_t cap = 64, n = 0;
+    typedef typename std::iterator_traits<InputIt>::iterator_category category;
+    if constexpr (std::is_base_of_v<std::forward_iterator_tag, category>) {
+      cap = std::distance(first, last);
+      if(!cap) return 0;
+      pool()->reserve(cap);
+    }
+    node** nodes = (node**) malloc(cap * sizeof(node*));
+    if(!nodes) throw std::bad_alloc();
+    try {
+      for(; first != last; ++first) {
+        if(n == cap) {
+          node** bigger = (node**) realloc(nodes, cap * 2 * sizeof(node*));
+          if(!bigger) throw std::bad_alloc();
+          nodes = bigger;
+          cap *= 2;
+        }
+        nodes[n] = make_node(std::in_place, *first);
+        ++n;
+      }
+    }
+    catch(...) {
+      for(size_t k = 0; k < n; ++k) drop_node(nodes[k]);
+      free(nodes);
+      throw;
+    }
+    try {
+      dst.build(nodes, n, [this] (node* p) { drop_node(p); });
+    }
+    catch(...) {
+      free(nodes);
+      throw;
+    }
+    free(nodes);
+    return n;
+  }
+  void destroy(core_type &h) {
+    h.clear([this] (node* p) { drop_node(p); });
   }
 };
 
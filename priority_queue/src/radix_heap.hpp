@@ -0,0 +1,216 @@
+#ifndef SJTU_RADIX_HEAP_HPP
+#define SJTU_RADIX_HEAP_HPP
+
+#include <bit>
+#include <climits>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "exceptions.hpp"
+#include "node_pool.hpp"
+
+namespace sjtu {
+/**
+ * a radix heap: a min-priority queue for unsigned keys that are popped
+ * in non-decreasing order, e.g. Dijkstra distances or event timestamps.
+ * A pushed key must not be smaller than the last popped one
+ * (runtime_error otherwise); the top is the entry with the smallest key.
+ *
+ * Entries live in buckets by the highest bit in which their key differs
+ * from the last popped key. When bucket 0 (keys equal to it) is empty,
+ * pop splits the first non-empty bucket over the lower ones, so every
+ * entry moves down at most once per bit: O(logC) amortized per entry for
+ * keys below C. Moving only relinks nodes, so pop never allocates or throws.
+ */
+template<typename Key, typename Value>
+class radix_heap {
+  static_assert(std::is_unsigned<Key>::value, "radix_heap needs unsigned keys");
+private:
+  class node {
+  public:
+    node* next;
+    Key key;
+    Value value;
+    template<class... Args>
+    node(Key k, Args&&... args) : next(nullptr), key(k), value(std::forward<Args>(args)...) {}
+  };
+  typedef node_pool<node> pool_type;
+  static constexpr int buckets = sizeof(Key) * CHAR_BIT + 1;
+
+  size_t siz;
+  Key last;
+  node* bucket[buckets];
+  mutable node* best; // smallest entry while bucket 0 is empty, if known
+  pool_type* mem;
+
+public:
+  radix_heap() : siz(0), last(0), best(nullptr), mem(nullptr) {
+    for(int i = 0; i < buckets; ++i) bucket[i] = nullptr;
+  }
+  // The delegated constructor has finished, so a throw runs the destructor
+  radix_heap(const radix_heap &other) : radix_heap() {
+    for(int i = 0; i < buckets; ++i) {
+      node** dst = &bucket[i];
+      for(node* p = other.bucket[i]; p; p = p->next) {
+        *dst = make_node(p->key, p->value);
+        dst = &(*dst)->next;
+      }
+    }
+    siz = other.siz;
+    last = other.last;
+  }
+  ~radix_heap() {
+    if(!mem) return;
+    // The pool frees the storage, only values may need destructing
+    if(!std::is_trivially_destructible<Value>::value) {
+      for(int i = 0; i < buckets; ++i) {
+        for(node* p = bucket[i]; p; ) {
+          node* nxt = p->next;
+          p->~node();
+          p = nxt;
+        }
+      }
+    }
+    pool_type::release(mem);
+  }
+  radix_heap &operator=(const radix_heap &other) {
+    if(this == &other) return *this;
+    radix_heap tmp(other);
+    swap(tmp);
+    return *this;
+  }
+  void swap(radix_heap &other) {
+    std::swap(siz, other.siz);
+    std::swap(last, other.last);
+    std::swap(best, other.best);
+    std::swap(mem, other.mem);
+    for(int i = 0; i < buckets; ++i) std::swap(bucket[i], other.bucket[i]);
+  }
+  /**
+   * the value with the smallest key.
+   * throw container_is_empty if empty() returns true;
+   */
+  const Value & top() const {
+    if(empty()) throw container_is_empty();
+    return front()->value;
+  }
+  Key top_key() const {
+    if(empty()) throw container_is_empty();
+    return front()->key;
+  }
+
+  void push(Key key, const Value &v) {
+    emplace(key, v);
+  }
+  void push(Key key, Value &&v) {
+    emplace(key, std::move(v));
+  }
+  /**
+   * construct the value of key in place from args.
+   */
+  template<class... Args>
+  void emplace(Key key, Args&&... args) {
+    if(key < last) throw runtime_error();
+    node* add = make_node(key, std::forward<Args>(args)...);
+    // A key equal to last goes to bucket 0, which best does not cover
+    if(best && key != last && key < best->key) best = add;
+    link(add);
+    ++siz;
+  }
+  /**
+   * delete the top element.
+   * throw container_is_empty if empty() returns true;
+   */
+  void pop() {
+    if(empty()) throw container_is_empty();
+    drop_node(unlink_top());
+  }
+  /**
+   * delete the top element and return its value, moved out of the heap.
+   * throw container_is_empty if empty() returns true;
+   */
+  Value pop_value() {
+    if(empty()) throw container_is_empty();
+    class guard {
+    public:
+      radix_heap* h;
+      node* p;
+      ~guard() { h->drop_node(p); }
+    } temp{this, unlink_top()};
+    return std::move(temp.p->value);
+  }
+  size_t size() const {
+    return siz;
+  }
+  bool empty() const {
+    return siz == 0;
+  }
+
+private:
+  template<class... Args>
+  node* make_node(Key key, Args&&... args) {
+    if(!mem) mem = pool_type::create();
+    void* raw = mem->allocate();
+    try {
+      return new(raw) node(key, std::forward<Args>(args)...);
+    }
+    catch(...) {
+      mem->deallocate(raw);
+      throw;
+    }
+  }
+  void drop_node(node* p) {
+    p->~node();
+    mem->deallocate(p);
+  }
+  void link(node* p) {
+    int b = std::bit_width(Key(p->key ^ last));
+    p->next = bucket[b];
+    bucket[b] = p;
+  }
+  // Keys in a lower bucket are smaller, so the top is in the first one
+  node* front() const {
+    if(bucket[0]) return bucket[0];
+    if(!best) {
+      int i = 1;
+      while(!bucket[i]) ++i;
+      best = bucket[i];
+      for(node* p = best->next; p; p = p->next) {
+        if(p->key < best->key) best = p;
+      }
+    }
+    return best;
+  }
+  node* unlink_top() {
+    if(!bucket[0]) pull();
+    node* ret = bucket[0];
+    bucket[0] = ret->next;
+    --siz;
+    return ret;
+  }
+  /**
+   * refill bucket 0 from the first non-empty bucket, whose minimum becomes
+   * last. That minimum is what top() showed, so it is linked last to end
+   * up first in bucket 0.
+   */
+  void pull() {
+    node* min = front();
+    last = min->key;
+    best = nullptr;
+    int i = 1;
+    while(!bucket[i]) ++i;
+    node* list = bucket[i];
+    bucket[i] = nullptr;
+    while(list) {
+      node* nxt = list->next;
+      if(list != min) link(list);
+      list = nxt;
+    }
+    link(min);
+  }
+};
+
+}
+
+#endif
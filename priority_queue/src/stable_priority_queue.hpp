@@ -0,0 +1,91 @@
+#ifndef SJTU_STABLE_PRIORITY_QUEUE_HPP
+#define SJTU_STABLE_PRIORITY_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include "heap_policy.hpp"
+#include "priority_queue.hpp"
+
+namespace sjtu {
+/**
+ * a priority_queue that pops equal elements in the order they were pushed.
+ * Every element is tagged with a 64-bit stamp from a counter shared by all
+ * queues of the type, so the order also holds for merged queues.
+ * The stamp lives next to the element inside the node, T stays as it is.
+ */
+template<typename T, class Compare = std::less<T>, class Policy = leftist_policy>
+class stable_priority_queue {
+private:
+  class entry {
+  public:
+    T value;
+    uint64_t stamp;
+    template<class... Args>
+    entry(uint64_t s, Args&&... args) : value(std::forward<Args>(args)...), stamp(s) {}
+  };
+  // a ranks below b: smaller, or equal and pushed later
+  class entry_less {
+  public:
+    bool operator()(const entry &a, const entry &b) const {
+      bool less = Compare()(a.value, b.value);
+      bool greater = Compare()(b.value, a.value);
+      return less | (!greater & (a.stamp > b.stamp)); // no short circuit
+    }
+  };
+
+  static inline std::atomic<uint64_t> clock{0};
+
+  priority_queue<entry, entry_less, Policy> q;
+
+  static uint64_t next_stamp() {
+    return clock.fetch_add(1, std::memory_order_relaxed);
+  }
+
+public:
+  /**
+   * get the top of the queue, the earliest pushed among equals.
+   * throw container_is_empty if empty() returns true;
+   */
+  const T & top() const {
+    return q.top().value;
+  }
+  void push(const T &e) {
+    q.emplace(next_stamp(), e);
+  }
+  void push(T &&e) {
+    q.emplace(next_stamp(), std::move(e));
+  }
+  template<class... Args>
+  void emplace(Args&&... args) {
+    q.emplace(next_stamp(), std::forward<Args>(args)...);
+  }
+  /**
+   * throw container_is_empty if empty() returns true;
+   */
+  void pop() {
+    q.pop();
+  }
+  T pop_value() {
+    return std::move(q.pop_value().value);
+  }
+  /**
+   * merge other into this, clearing other. Equal elements keep the order
+   * in which they were pushed, whichever queue they came from.
+   */
+  void merge(stable_priority_queue &other) {
+    q.merge(other.q);
+  }
+  size_t size() const {
+    return q.size();
+  }
+  bool empty() const {
+    return q.empty();
+  }
+};
+
+}
+
+#endif
@@ -0,0 +1,277 @@
+#ifndef SJTU_TIMING_WHEEL_HPP
+#define SJTU_TIMING_WHEEL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "exceptions.hpp"
+#include "node_pool.hpp"
+#include "priority_queue.hpp"
+
+namespace sjtu {
+/**
+ * a hierarchical timing wheel for timeouts, driven by a tick counter.
+ * schedule and cancel are O(1); advance fires every timer whose deadline
+ * has been reached, once per tick, in batches of one slot.
+ *
+ * Level k has 2^Bits slots of 2^(Bits * k) ticks each. A timer sits in the
+ * level of the highest Bits-group in which its deadline differs from the
+ * current tick; when the clock enters its slot, it cascades to a lower
+ * level, at most Levels - 1 times in total. Deadlines more than about
+ * 2^(Bits * Levels) ticks away wait in a priority_queue instead and move
+ * into the wheel when the clock gets near; cancelling them only marks them.
+ */
+template<typename Value, int Bits = 8, int Levels = 4>
+class timing_wheel {
+  static_assert(Bits > 0 && Levels > 0 && Bits * Levels < 64, "the wheel must fit in 64-bit ticks");
+private:
+  static constexpr int slots = 1 << Bits;
+  static constexpr uint64_t mask = slots - 1;
+  static constexpr int span = Bits * Levels;
+  static constexpr int in_heap = -1;
+  static constexpr int in_due = -2;
+
+  class node {
+  public:
+    node* prev;
+    node* next;
+    uint64_t deadline;
+    uint64_t when;  // the tick it fires at, later than deadline if that had passed
+    int level;      // in_heap, in_due, or a wheel level
+    bool cancelled; // only for nodes in the heap
+    Value value;
+    template<class... Args>
+    node(uint64_t d, Args&&... args) : prev(nullptr), next(nullptr), deadline(d), when(d),
+                                       level(0), cancelled(false), value(std::forward<Args>(args)...) {}
+  };
+  typedef node_pool<node> pool_type;
+
+  class far_timer {
+  public:
+    uint64_t when;
+    node* p;
+  };
+  class later {
+  public:
+    bool operator()(const far_timer &a, const far_timer &b) const {
+      return a.when > b.when;
+    }
+  };
+
+  uint64_t cur;
+  size_t siz;
+  node* wheel[Levels][slots];
+  node* due; // detached slot being fired
+  priority_queue<far_timer, later> far;
+  pool_type* mem;
+
+public:
+  /**
+   * a scheduled timer, valid until it fires or is cancelled.
+   */
+  class timer {
+    friend class timing_wheel;
+  private:
+    node* p;
+    timer(node* _p) : p(_p) {}
+  public:
+    timer() : p(nullptr) {}
+    bool operator==(const timer &rhs) const { return p == rhs.p; }
+    bool operator!=(const timer &rhs) const { return p != rhs.p; }
+  };
+
+  explicit timing_wheel(uint64_t start = 0) : cur(start), siz(0), due(nullptr) {
+    for(int k = 0; k < Levels; ++k) {
+      for(int s = 0; s < slots; ++s) wheel[k][s] = nullptr;
+    }
+    mem = pool_type::create();
+  }
+  // Timers refer to nodes of this wheel
+  timing_wheel(const timing_wheel &) = delete;
+  timing_wheel &operator=(const timing_wheel &) = delete;
+  ~timing_wheel() {
+    while(!far.empty()) {
+      far.top().p->~node();
+      far.pop();
+    }
+    if(!std::is_trivially_destructible<Value>::value) {
+      for(int k = 0; k < Levels; ++k) {
+        for(int s = 0; s < slots; ++s) drop_list(wheel[k][s]);
+      }
+      drop_list(due);
+    }
+    pool_type::release(mem);
+  }
+
+  uint64_t now() const {
+    return cur;
+  }
+  size_t size() const {
+    return siz;
+  }
+  bool empty() const {
+    return siz == 0;
+  }
+  /**
+   * fire value at tick deadline; a deadline not after now() fires
+   * on the next tick.
+   */
+  timer schedule(uint64_t deadline, const Value &value) {
+    return emplace(deadline, value);
+  }
+  timer schedule(uint64_t deadline, Value &&value) {
+    return emplace(deadline, std::move(value));
+  }
+  template<class... Args>
+  timer emplace(uint64_t deadline, Args&&... args) {
+    void* raw = mem->allocate();
+    node* p;
+    try {
+      p = new(raw) node(deadline, std::forward<Args>(args)...);
+    }
+    catch(...) {
+      mem->deallocate(raw);
+      throw;
+    }
+    if(p->when <= cur) p->when = cur + 1;
+    try {
+      place(p);
+    }
+    catch(...) { // the heap could not take it
+      drop_node(p);
+      throw;
+    }
+    ++siz;
+    return timer(p);
+  }
+  uint64_t deadline(const timer &t) const {
+    return t.p->deadline;
+  }
+  const Value & get(const timer &t) const {
+    return t.p->value;
+  }
+  /**
+   * stop t from firing, invalidating t.
+   */
+  void cancel(const timer &t) {
+    node* p = t.p;
+    --siz;
+    if(p->level == in_heap) { // freed when it comes out of the heap
+      p->cancelled = true;
+      return;
+    }
+    unlink(p);
+    drop_node(p);
+  }
+  /**
+   * move the clock ticks ticks forward, calling expire(Value &) for every
+   * timer that comes due, in order of ticks. expire may schedule and cancel
+   * timers. If it throws, the clock stays at the tick being fired and the
+   * rest of that batch fires on the next call.
+   */
+  template<class F>
+  void advance(uint64_t ticks, F expire) {
+    fire(expire);
+    while(ticks--) {
+      if(!siz) { // nothing can fire, skip the empty slots
+        purge();
+        cur += ticks + 1;
+        return;
+      }
+      ++cur;
+      if(!(cur & ((uint64_t(1) << span) - 1))) refill();
+      for(int k = Levels - 1; k > 0; --k) {
+        if(cur & ((uint64_t(1) << (Bits * k)) - 1)) continue;
+        node* list = take(wheel[k][(cur >> (Bits * k)) & mask]);
+        while(list) {
+          node* nxt = list->next;
+          place(list);
+          list = nxt;
+        }
+      }
+      due = take(wheel[0][cur & mask]);
+      for(node* p = due; p; p = p->next) p->level = in_due;
+      fire(expire);
+    }
+  }
+
+private:
+  void drop_node(node* p) {
+    p->~node();
+    mem->deallocate(p);
+  }
+  void drop_list(node* p) {
+    while(p) {
+      node* nxt = p->next;
+      p->~node();
+      p = nxt;
+    }
+  }
+  static node* take(node* &head) {
+    node* ret = head;
+    head = nullptr;
+    return ret;
+  }
+  // File p by the highest Bits-group in which when and now differ
+  void place(node* p) {
+    uint64_t diff = p->when ^ cur;
+    if(diff >> span) {
+      far.push(far_timer{p->when, p});
+      p->level = in_heap;
+      return;
+    }
+    int k = 0;
+    while(diff >> (Bits * (k + 1))) ++k;
+    node* &head = wheel[k][(p->when >> (Bits * k)) & mask];
+    p->level = k;
+    p->prev = nullptr;
+    p->next = head;
+    if(head) head->prev = p;
+    head = p;
+  }
+  void unlink(node* p) {
+    if(p->prev) p->prev->next = p->next;
+    else if(p->level == in_due) due = p->next;
+    else wheel[p->level][(p->when >> (Bits * p->level)) & mask] = p->next;
+    if(p->next) p->next->prev = p->prev;
+  }
+  // The clock entered a new span: bring its far timers into the wheel
+  void refill() {
+    while(!far.empty() && !((far.top().when ^ cur) >> span)) {
+      node* p = far.top().p;
+      far.pop();
+      if(p->cancelled) drop_node(p);
+      else place(p);
+    }
+  }
+  // Only cancelled timers are left in the heap
+  void purge() {
+    while(!far.empty()) {
+      node* p = far.top().p;
+      far.pop();
+      drop_node(p);
+    }
+  }
+  template<class F>
+  void fire(F &expire) {
+    while(due) {
+      node* p = due;
+      due = p->next;
+      if(due) due->prev = nullptr;
+      --siz;
+      class guard {
+      public:
+        timing_wheel* w;
+        node* p;
+        ~guard() { w->drop_node(p); }
+      } hold{this, p};
+      expire(p->value);
+    }
+  }
+};
+
+}
+
+#endif
@@ -0,0 +1,208 @@
+#ifndef SJTU_TOPK_HPP
+#define SJTU_TOPK_HPP
+
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <utility>
+#include "exceptions.hpp"
+
+namespace sjtu {
+/**
+ * keeps the k largest elements (under Compare) of everything offered.
+ * The k slots are allocated once by the constructor; the kept elements
+ * form a binary heap with the smallest of them, the threshold, on top,
+ * so an element that does not qualify costs one comparison once full.
+ *
+ * offer leaves the content unchanged if Compare or a copy of T throws.
+ */
+template<typename T, class Compare = std::less<T>>
+class topk {
+private:
+  size_t siz, capacity;
+  T* data;
+
+public:
+  explicit topk(size_t k) : siz(0), capacity(k) {
+    data = alloc(capacity);
+  }
+  topk(const topk &other) : siz(0), capacity(other.capacity) {
+    data = alloc(capacity);
+    try {
+      for(; siz < other.siz; ++siz) {
+        new(data + siz) T(other.data[siz]);
+      }
+    }
+    catch(...) {
+      destroy();
+      throw;
+    }
+  }
+  ~topk() {
+    destroy();
+  }
+  topk &operator=(const topk &other) {
+    if(this == &other) return *this;
+    topk tmp(other);
+    swap(tmp);
+    return *this;
+  }
+  void swap(topk &other) {
+    std::swap(siz, other.siz);
+    std::swap(capacity, other.capacity);
+    std::swap(data, other.data);
+  }
+  /**
+   * the smallest kept element, which a new one has to beat once full.
+   * throw container_is_empty if empty() returns true;
+   */
+  const T & threshold() const {
+    if(empty()) throw container_is_empty();
+    return data[0];
+  }
+  size_t size() const {
+    return siz;
+  }
+  size_t k() const {
+    return capacity;
+  }
+  bool empty() const {
+    return siz == 0;
+  }
+  bool full() const {
+    return siz == capacity;
+  }
+  /**
+   * keep e if it is among the k largest so far.
+   * @return whether e was kept.
+   */
+  bool offer(const T &e) {
+    return take(e);
+  }
+  bool offer(T &&e) {
+    return take(std::move(e));
+  }
+  /**
+   * offer every element of [first, last).
+   * @return the number of elements kept at the time they were offered.
+   */
+  template<class InputIt>
+  size_t offer(InputIt first, InputIt last) {
+    size_t kept = 0;
+    for(; first != last && siz < capacity; ++first) {
+      kept += take(*first);
+    }
+    if(!capacity) return kept;
+    for(; first != last; ++first) {
+      if(!Compare()(data[0], *first)) continue;
+      replace_top(*first);
+      ++kept;
+    }
+    return kept;
+  }
+  /**
+   * move the kept elements to out, largest first, and clear.
+   * If Compare throws, the elements are destroyed and topk is empty.
+   */
+  template<class OutIt>
+  OutIt extract_sorted(OutIt out) {
+    try {
+      // Heap sort: the smallest goes to the back first
+      for(size_t n = siz; n > 1; --n) {
+        T last = std::move(data[n - 1]);
+        data[n - 1] = std::move(data[0]);
+        sift_down(last, n - 1);
+      }
+    }
+    catch(...) {
+      clear();
+      throw;
+    }
+    for(size_t i = 0; i < siz; ++i) {
+      *out = std::move(data[i]);
+      ++out;
+    }
+    clear();
+    return out;
+  }
+  void clear() {
+    for(size_t i = 0; i < siz; ++i) {
+      data[i].~T();
+    }
+    siz = 0;
+  }
+
+private:
+  static T* alloc(size_t n) {
+    if(!n) return nullptr;
+    T* p = (T*) malloc(n * sizeof(T));
+    if(!p) throw std::bad_alloc();
+    return p;
+  }
+  void destroy() {
+    clear();
+    free(data);
+  }
+  template<class Arg>
+  bool take(Arg &&e) {
+    if(siz < capacity) {
+      push(std::forward<Arg>(e));
+      return true;
+    }
+    if(!capacity || !Compare()(data[0], e)) return false;
+    replace_top(std::forward<Arg>(e));
+    return true;
+  }
+  // Find the slot first, nothing moves if Compare throws
+  template<class Arg>
+  void push(Arg &&e) {
+    new(data + siz) T(std::forward<Arg>(e));
+    size_t hole = siz;
+    try {
+      while(hole > 0 && Compare()(data[siz], data[(hole - 1) / 2])) {
+        hole = (hole - 1) / 2;
+      }
+    }
+    catch(...) {
+      data[siz].~T();
+      throw;
+    }
+    if(hole != siz) {
+      T val = std::move(data[siz]);
+      for(size_t i = siz; i != hole; i = (i - 1) / 2) {
+        data[i] = std::move(data[(i - 1) / 2]);
+      }
+      data[hole] = std::move(val);
+    }
+    ++siz;
+  }
+  template<class Arg>
+  void replace_top(Arg &&e) {
+    T val(std::forward<Arg>(e));
+    sift_down(val, siz);
+  }
+  // Put val into the hole at the top of data[0, n)
+  void sift_down(T &val, size_t n) {
+    size_t path[sizeof(size_t) * 8];
+    int len = 0;
+    size_t hole = 0;
+    while(2 * hole + 1 < n) {
+      size_t c = 2 * hole + 1;
+      if(c + 1 < n && Compare()(data[c + 1], data[c])) ++c;
+      if(!Compare()(data[c], val)) break;
+      path[len++] = c;
+      hole = c;
+    }
+    size_t cur = 0;
+    for(int i = 0; i < len; ++i) {
+      data[cur] = std::move(data[path[i]]);
+      cur = path[i];
+    }
+    data[cur] = std::move(val);
+  }
+};
+
+}
+
+#endif
@@ -0,0 +1,116 @@
+#include "vector.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+int rand()
+{
+	static unsigned reed = 1727417277;
+	return (reed = reed * 1103515245u + 12345u) >> 1;
+}
+
+template<typename T>
+bool same(const sjtu::vector<T> &v, const std::vector<T> &ref)
+{
+	if (v.size() != ref.size()) return false;
+	for (size_t i = 0; i < ref.size(); i++) {
+		if (v[i] != ref[i]) return false;
+	}
+	return true;
+}
+
+// the second member records the position, so any reordering shows
+template<typename T>
+void make(size_t n, int range, sjtu::vector<T> &v, std::vector<T> &ref)
+{
+	v.clear();
+	ref.clear();
+	for (size_t i = 0; i < n; i++) {
+		T x(rand() % range, std::to_string(i));
+		v.push_back(x);
+		ref.push_back(x);
+	}
+}
+
+typedef std::pair<int, std::string> item;
+
+bool testEraseIf()
+{
+	sjtu::vector<int> e;
+	if (e.erase_if([] (int) { return true; }) != 0 || !e.empty()) return false;
+	sjtu::vector<long long> num;
+	std::vector<long long> ref;
+	for (int i = 0; i < 10000; i++) {
+		num.push_back(rand() % 100);
+		ref.push_back(num.back());
+	}
+	auto odd = [] (long long x) { return x % 2 != 0; };
+	size_t removed = num.erase_if(odd);
+	auto it = std::remove_if(ref.begin(), ref.end(), odd);
+	if (removed != size_t(ref.end() - it)) return false;
+	ref.erase(it, ref.end());
+	if (!same(num, ref)) return false;
+	sjtu::vector<item> v;
+	std::vector<item> r;
+	for (size_t n : {1, 2, 1000}) {
+		make(n, 5, v, r);
+		auto small = [] (const item &x) { return x.first < 2; };
+		v.erase_if(small);
+		r.erase(std::remove_if(r.begin(), r.end(), small), r.end());
+		if (!same(v, r)) return false;
+	}
+	return v.erase_if([] (const item &) { return true; }) == r.size() && v.empty();
+}
+
+bool testUnique()
+{
+	sjtu::vector<int> e;
+	if (e.unique() != 0 || !e.empty()) return false;
+	sjtu::vector<int> num;
+	std::vector<int> ref;
+	for (int i = 0; i < 10000; i++) {
+		num.push_back(rand() % 3);
+		ref.push_back(num.back());
+	}
+	size_t removed = num.unique();
+	auto it = std::unique(ref.begin(), ref.end());
+	if (removed != size_t(ref.end() - it)) return false;
+	ref.erase(it, ref.end());
+	if (!same(num, ref)) return false;
+	sjtu::vector<item> v;
+	std::vector<item> r;
+	for (size_t n : {1, 2, 1000}) {
+		make(n, 3, v, r);
+		auto eq = [] (const item &a, const item &b) { return a.first == b.first; };
+		v.unique(eq);
+		r.erase(std::unique(r.begin(), r.end(), eq), r.end());
+		if (!same(v, r)) return false;
+	}
+	return true;
+}
+
+bool testStablePartition()
+{
+	sjtu::vector<item> v;
+	std::vector<item> r;
+	for (size_t n : {0, 1, 2, 1000}) {
+		make(n, 10, v, r);
+		auto small = [] (const item &x) { return x.first < 3; };
+		auto mid = v.stable_partition(small);
+		auto rmid = std::stable_partition(r.begin(), r.end(), small);
+		if (mid - v.begin() != rmid - r.begin() || !same(v, r)) return false;
+	}
+	auto none = v.stable_partition([] (const item &) { return false; });
+	auto all = v.stable_partition([] (const item &) { return true; });
+	return none == v.begin() && all == v.end() && same(v, r);
+}
+
+int main()
+{
+	std::cout << (testEraseIf() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (testUnique() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (testStablePartition() ? "OKAY" : "FAIL") << std::endl;
+	return 0;
+}
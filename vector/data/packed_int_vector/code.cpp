@@ -0,0 +1,75 @@
+#include "packed_int_vector.hpp"
+
+#include <iostream>
+#include <vector>
+
+int rand()
+{
+	static unsigned reed = 1727417277;
+	return (reed = reed * 1103515245u + 12345u) >> 1;
+}
+
+// values of mixed spread, so blocks get bit widths from 0 up to the full type
+template<typename T>
+bool testRoundTrip(std::vector<T> &ref)
+{
+	sjtu::packed_int_vector<T> v;
+	for (int b = 0; b < 300; b++) {
+		int width = rand() % (sizeof(T) * 8 + 1);
+		unsigned long long base = (unsigned long long) rand() * rand();
+		for (int i = 0; i < 100 + rand() % 60; i++) {
+			unsigned long long r = (unsigned long long) rand() << 33 ^ (unsigned long long) rand() << 2 ^ rand();
+			T x = T(width ? base + (r >> (64 - width)) : base);
+			v.push_back(x);
+			ref.push_back(x);
+		}
+	}
+	if (v.size() != ref.size() || v.back() != ref.back()) return false;
+	for (size_t i = 0; i < ref.size(); i++) {
+		if (v[i] != ref[i]) return false;
+	}
+	for (int k = 0; k < 1000; k++) {
+		size_t pos = rand() % ref.size(), n = rand() % (ref.size() - pos + 1);
+		std::vector<T> out(n);
+		v.decode(pos, n, out.data());
+		for (size_t i = 0; i < n; i++) {
+			if (out[i] != ref[pos + i]) return false;
+		}
+	}
+	size_t i = 0;
+	bool ok = true;
+	v.for_each([&] (T x) { ok = ok && x == ref[i++]; });
+	if (!ok || i != ref.size()) return false;
+	sjtu::packed_int_vector<T> copy(v);
+	v.clear();
+	try {
+		v.at(0);
+		return false;
+	} catch (sjtu::index_out_of_bound &) {}
+	return v.empty() && copy.size() == ref.size() && copy[ref.size() / 2] == ref[ref.size() / 2];
+}
+
+// sorted, close values pack into a few bits each
+bool testCompression()
+{
+	sjtu::packed_int_vector<unsigned long long> v;
+	unsigned long long x = 1ull << 40;
+	for (int i = 0; i < 128 * 1000; i++) {
+		x += rand() % 16;
+		v.push_back(x);
+	}
+	std::cout << v.size() << " " << (v.memory_usage() < v.size() * 2) << std::endl;
+	return v.back() == x;
+}
+
+int main()
+{
+	std::vector<unsigned long long> u;
+	std::vector<long long> s;
+	std::vector<unsigned> w;
+	std::cout << (testRoundTrip(u) ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (testRoundTrip(s) ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (testRoundTrip(w) ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (testCompression() ? "OKAY" : "FAIL") << std::endl;
+	return 0;
+}
@@ -0,0 +1,72 @@
+#include "vector.hpp"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+int rand()
+{
+	static unsigned reed = 1727417277;
+	return (reed = reed * 1103515245u + 12345u) >> 1;
+}
+
+template<typename T>
+bool same(const sjtu::vector<T> &v, const std::vector<T> &ref)
+{
+	if (v.size() != ref.size()) return false;
+	for (size_t i = 0; i < ref.size(); i++) {
+		if (v[i] != ref[i]) return false;
+	}
+	return true;
+}
+
+// large enough that every thread gets its own chunk
+bool testCopy()
+{
+	sjtu::vector<long long> v;
+	std::vector<long long> ref;
+	for (int i = 0; i < 300000; i++) {
+		long long x = rand();
+		v.push_back(x);
+		ref.push_back(x);
+	}
+	sjtu::vector<long long> one(v, 1), four(v, 4), many(v, 64);
+	sjtu::vector<long long> none(sjtu::vector<long long>(), 4);
+	return same(one, ref) && same(four, ref) && same(many, ref) && none.empty();
+}
+
+bool testConstructFill()
+{
+	sjtu::vector<std::string> v(300000, "pq", 4);
+	if (!same(v, std::vector<std::string>(300000, "pq"))) return false;
+	v.fill("heap", 4);
+	if (!same(v, std::vector<std::string>(300000, "heap"))) return false;
+	v.fill("x");
+	sjtu::vector<int> e(0, 7, 4);
+	e.fill(1, 4);
+	return same(v, std::vector<std::string>(300000, "x")) && e.empty();
+}
+
+// value may be an element of the vector itself, also when it grows
+bool testAssign()
+{
+	sjtu::vector<std::string> v;
+	v.push_back("first element, long enough to be on the heap");
+	v.push_back("b");
+	v.assign(3, v[0]);
+	if (!same(v, std::vector<std::string>(3, "first element, long enough to be on the heap"))) return false;
+	v.assign(300000, v[1], 4);
+	if (!same(v, std::vector<std::string>(300000, "first element, long enough to be on the heap"))) return false;
+	v.assign(2, v[299999], 4);
+	if (!same(v, std::vector<std::string>(2, "first element, long enough to be on the heap"))) return false;
+	v.assign(0, "z");
+	return v.empty();
+}
+
+int main()
+{
+	std::cout << (testCopy() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (testConstructFill() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (testAssign() ? "OKAY" : "FAIL") << std::endl;
+	return 0;
+}
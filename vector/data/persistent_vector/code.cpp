@@ -0,0 +1,115 @@
+#include "persistent_vector.hpp"
+
+#include <iostream>
+#include <vector>
+
+int rand()
+{
+	static unsigned reed = 1727417277;
+	return (reed = reed * 1103515245u + 12345u) >> 1;
+}
+
+// Nodes keep at least half their slots on average, so this is generous
+int maxDepth(size_t n)
+{
+	int d = 1;
+	for (size_t cap = 16; cap < n; cap *= 16) ++d;
+	return d;
+}
+
+template<typename T>
+bool same(const sjtu::persistent_vector<T> &v, const std::vector<T> &ref)
+{
+	if (v.size() != ref.size()) return false;
+	for (size_t i = 0; i < ref.size(); ++i) {
+		if (v[i] != ref[i]) return false;
+	}
+	size_t i = 0;
+	bool ok = true;
+	v.for_each([&](const T &x) { ok = ok && x == ref[i++]; });
+	return ok && i == ref.size();
+}
+
+bool TestPrepend()
+{
+	sjtu::persistent_vector<int> acc, piece;
+	std::vector<int> ref;
+	for (int i = 0; i < 2048; ++i) {
+		piece = piece.push_back(2 * i).push_back(2 * i + 1).slice(piece.size(), piece.size() + 2);
+		acc = piece.concat(acc);
+		ref.insert(ref.begin(), {2 * i, 2 * i + 1});
+		if (acc.depth() > maxDepth(acc.size())) return false;
+	}
+	std::cout << acc.size() << " " << acc.depth() << std::endl;
+	return same(acc, ref);
+}
+
+bool TestAppend()
+{
+	sjtu::persistent_vector<int> acc;
+	std::vector<int> ref;
+	for (int i = 0; i < 3000; ++i) {
+		sjtu::persistent_vector<int> piece;
+		int len = rand() % 5 + 1;
+		for (int j = 0; j < len; ++j) {
+			piece = piece.push_back(i * 10 + j);
+			ref.push_back(i * 10 + j);
+		}
+		acc = acc.concat(piece);
+		if (acc.depth() > maxDepth(acc.size())) return false;
+	}
+	std::cout << acc.size() << " " << acc.depth() << std::endl;
+	return same(acc, ref);
+}
+
+bool TestSliceConcat()
+{
+	sjtu::persistent_vector<int> v;
+	std::vector<int> ref;
+	for (int i = 0; i < 1000; ++i) {
+		v = v.push_back(i);
+		ref.push_back(i);
+	}
+	sjtu::persistent_vector<int> first = v;
+	for (int round = 0; round < 3000; ++round) {
+		size_t a = rand() % (v.size() + 1), b = rand() % (v.size() + 1);
+		if (a > b) std::swap(a, b);
+		if (round % 2 == 0) {
+			// insert a few elements at a
+			sjtu::persistent_vector<int> piece;
+			for (int j = rand() % 3; j >= 0; --j) {
+				piece = piece.push_back(round);
+				ref.insert(ref.begin() + a, round);
+			}
+			v = v.slice(0, a).concat(piece).concat(v.slice(a, v.size()));
+		} else if (b - a < v.size() / 4) {
+			// move [a, b) to the front
+			v = v.slice(a, b).concat(v.slice(0, a)).concat(v.slice(b, v.size()));
+			std::vector<int> next(ref.begin() + a, ref.begin() + b);
+			next.insert(next.end(), ref.begin(), ref.begin() + a);
+			next.insert(next.end(), ref.begin() + b, ref.end());
+			ref.swap(next);
+		}
+		if (v.depth() > maxDepth(v.size())) return false;
+		if (round % 100 == 0) {
+			size_t pos = rand() % v.size();
+			v = v.set(pos, -round);
+			ref[pos] = -round;
+			if (!same(v, ref)) return false;
+		}
+	}
+	std::cout << v.size() << " " << v.depth() << std::endl;
+	if (!same(v, ref)) return false;
+	for (int i = 0; i < 1000; ++i) {
+		if (first[i] != i) return false;
+	}
+	return true;
+}
+
+int main()
+{
+	std::cout << (TestPrepend() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (TestAppend() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (TestSliceConcat() ? "OKAY" : "FAIL") << std::endl;
+	return 0;
+}
@@ -0,0 +1,111 @@
+#include "vector.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+int rand()
+{
+	static unsigned reed = 1727417277;
+	return (reed = reed * 1103515245u + 12345u) >> 1;
+}
+
+template<typename T>
+bool same(const sjtu::vector<T> &v, const std::vector<T> &ref)
+{
+	if (v.size() != ref.size()) return false;
+	for (size_t i = 0; i < ref.size(); i++) {
+		if (v[i] != ref[i]) return false;
+	}
+	return true;
+}
+
+// values in [0, range), range small for many duplicates
+void make(size_t n, int range, sjtu::vector<int> &v, std::vector<int> &ref)
+{
+	for (size_t i = 0; i < n; i++) {
+		int x = rand() % range - range / 2;
+		v.push_back(x);
+		ref.push_back(x);
+	}
+}
+
+bool testSort()
+{
+	size_t sizes[] = {0, 1, 15, 300, 100000};
+	for (size_t n : sizes) {
+		for (int range : {3, 1000000}) {
+			sjtu::vector<int> v;
+			std::vector<int> ref;
+			make(n, range, v, ref);
+			sjtu::vector<int> w(v);
+			v.sort();
+			std::sort(ref.begin(), ref.end());
+			if (!same(v, ref)) return false;
+			v.sort(); // already sorted
+			if (!same(v, ref)) return false;
+			w.sort(std::greater<int>());
+			std::reverse(ref.begin(), ref.end());
+			if (!same(w, ref)) return false;
+		}
+	}
+	sjtu::vector<int> v;
+	std::vector<int> ref;
+	make(10000, 100, v, ref);
+	std::ranges::sort(v.begin(), v.end());
+	std::sort(ref.begin(), ref.end());
+	return same(v, ref);
+}
+
+bool testRadixSort()
+{
+	size_t sizes[] = {0, 1, 200, 300, 300000};
+	for (size_t n : sizes) {
+		for (int range : {3, 1000000}) {
+			for (unsigned threads : {1u, 4u}) {
+				sjtu::vector<int> v;
+				std::vector<int> ref;
+				make(n, range, v, ref);
+				v.radix_sort(sjtu::radix_identity(), threads);
+				std::sort(ref.begin(), ref.end());
+				if (!same(v, ref)) return false;
+				v.radix_sort(sjtu::radix_identity(), threads); // already sorted
+				if (!same(v, ref)) return false;
+			}
+		}
+	}
+	return true;
+}
+
+// sorting by a key extractor is stable: equal keys keep their order
+bool testRadixKey()
+{
+	for (unsigned threads : {1u, 4u}) {
+		for (size_t n : {100, 300000}) {
+			sjtu::vector<std::pair<long long, int>> v;
+			std::vector<std::pair<long long, int>> ref;
+			for (size_t i = 0; i < n; i++) {
+				std::pair<long long, int> x((long long) (rand() % 1000) - 500, (int) i);
+				v.push_back(x);
+				ref.push_back(x);
+			}
+			auto key = [] (const std::pair<long long, int> &p) { return p.first; };
+			v.radix_sort(key, threads);
+			std::stable_sort(ref.begin(), ref.end(), [] (const std::pair<long long, int> &a, const std::pair<long long, int> &b) {
+				return a.first < b.first;
+			});
+			if (!same(v, ref)) return false;
+		}
+	}
+	return true;
+}
+
+int main()
+{
+	std::cout << (testSort() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (testRadixSort() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << (testRadixKey() ? "OKAY" : "FAIL") << std::endl;
+	return 0;
+}
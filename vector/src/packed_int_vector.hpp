@@ -0,0 +1,219 @@
+#ifndef SJTU_PACKED_INT_VECTOR_HPP
+#define SJTU_PACKED_INT_VECTOR_HPP
+
+#include "exceptions.hpp"
+#include "vector.hpp"
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+
+namespace sjtu
+{
+/**
+ * an append-only integer container with frame-of-reference compression.
+ * Values are grouped into blocks of block_size; a full block is stored as
+ * its minimum plus (value - minimum) packed with the smallest bit width
+ * that fits the block. The last, unfilled block is kept raw.
+ * Supports random access in O(1) and block-wise sequential decoding.
+ */
+template<typename T = unsigned long long>
+class packed_int_vector
+{
+  static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>,
+                "packed_int_vector stores integers only");
+public:
+  static constexpr size_t block_size = 128;
+
+private:
+  using U = std::make_unsigned_t<T>;
+  using word = std::uint64_t;
+  struct block {
+    T base;
+    size_t offset; // first word of the block
+    unsigned width;
+  };
+
+  size_t siz;
+  vector<block> blocks;
+  word* words;
+  size_t used, capacity; // in words, one padding word is kept after used
+  T tail[block_size];
+
+public:
+  packed_int_vector() : siz(0), used(0), capacity(16) {
+    words = (word*) malloc(capacity * sizeof(word));
+    words[0] = 0;
+  }
+  packed_int_vector(const packed_int_vector &other)
+          : siz(other.siz), blocks(other.blocks), used(other.used), capacity(other.used + 1) {
+    words = (word*) malloc(capacity * sizeof(word));
+    memcpy(words, other.words, capacity * sizeof(word));
+    memcpy(tail, other.tail, sizeof(tail));
+  }
+  ~packed_int_vector() {
+    free(words);
+  }
+  packed_int_vector &operator=(const packed_int_vector &other) {
+    if(this != &other) {
+      free(words);
+      siz = other.siz, blocks = other.blocks;
+      used = other.used, capacity = other.used + 1;
+      words = (word*) malloc(capacity * sizeof(word));
+      memcpy(words, other.words, capacity * sizeof(word));
+      memcpy(tail, other.tail, sizeof(tail));
+    }
+    return *this;
+  }
+
+  /**
+   * returns the value at pos.
+   * throw index_out_of_bound if pos is not in [0, size)
+   */
+  T at(const size_t &pos) const {
+    if(pos >= siz) throw index_out_of_bound();
+    size_t b = pos / block_size, i = pos % block_size;
+    if(b == blocks.size()) return tail[i];
+    const block &blk = blocks[b];
+    return T(U(blk.base) + U(extract(words + blk.offset, i * blk.width, blk.width)));
+  }
+  T operator[](const size_t &pos) const {
+    return at(pos);
+  }
+  T back() const {
+    if(siz == 0) throw container_is_empty();
+    return at(siz - 1);
+  }
+  bool empty() const {
+    return siz == 0;
+  }
+  size_t size() const {
+    return siz;
+  }
+  // bytes taken by the packed words and block headers
+  size_t memory_usage() const {
+    return used * sizeof(word) + blocks.size() * sizeof(block) + sizeof(tail);
+  }
+  void clear() {
+    free(words);
+    siz = 0, used = 0, capacity = 16;
+    blocks.clear();
+    words = (word*) malloc(capacity * sizeof(word));
+    words[0] = 0;
+  }
+  /**
+   * adds a value to the end, a block is packed once it is full.
+   */
+  void push_back(const T &value) {
+    tail[siz % block_size] = value;
+    ++siz;
+    if(siz % block_size == 0) seal();
+  }
+  /**
+   * writes the n values starting at pos into out.
+   * Full blocks are unpacked straight into out.
+   * throw index_out_of_bound if [pos, pos + n) is not inside [0, size)
+   */
+  void decode(size_t pos, size_t n, T* out) const {
+    if(pos > siz || n > siz - pos) throw index_out_of_bound();
+    T buf[block_size];
+    while(n > 0) {
+      size_t b = pos / block_size, i = pos % block_size;
+      size_t len = block_size - i < n ? block_size - i : n;
+      if(b == blocks.size()) {
+        memcpy(out, tail + i, len * sizeof(T));
+      }
+      else if(len == block_size) {
+        unpack(blocks[b], out);
+      }
+      else {
+        unpack(blocks[b], buf);
+        memcpy(out, buf + i, len * sizeof(T));
+      }
+      pos += len, n -= len, out += len;
+    }
+  }
+  /**
+   * calls f(value) for every value in order, one block decoded at a time.
+   */
+  template<class F>
+  void for_each(F f) const {
+    T buf[block_size];
+    for(size_t b = 0; b < blocks.size(); ++b) {
+      unpack(blocks[b], buf);
+      for(size_t i = 0; i < block_size; ++i) f(buf[i]);
+    }
+    for(size_t i = 0; i < siz % block_size; ++i) f(tail[i]);
+  }
+
+private:
+  static word mask(unsigned width) {
+    return width == 64 ? ~word(0) : (word(1) << width) - 1;
+  }
+  // Read width bits at bit, the word after the last one must be readable
+  static word extract(const word* w, size_t bit, unsigned width) {
+    if(width == 0) return 0; // w may point past the padding word
+    size_t k = bit / 64;
+    unsigned s = bit % 64;
+    // (x << 1) << (63 - s) avoids the undefined shift by 64 when s == 0
+    return ((w[k] >> s) | ((w[k + 1] << 1) << (63 - s))) & mask(width);
+  }
+  /**
+   * decode a full block, the loop has no branches so the compiler
+   * can unroll and vectorize it for every width.
+   */
+  void unpack(const block &blk, T* out) const {
+    const word* w = words + blk.offset;
+    const U base = U(blk.base);
+    const unsigned width = blk.width;
+    if(width == 0) {
+      for(size_t i = 0; i < block_size; ++i) out[i] = blk.base;
+      return;
+    }
+    const word m = mask(width);
+    for(size_t i = 0; i < block_size; ++i) {
+      size_t bit = i * width;
+      size_t k = bit / 64;
+      unsigned s = bit % 64;
+      word v = ((w[k] >> s) | ((w[k + 1] << 1) << (63 - s))) & m;
+      out[i] = T(base + U(v));
+    }
+  }
+  // Pack the full tail into a new block
+  void seal() {
+    T lo = tail[0], hi = tail[0];
+    for(size_t i = 1; i < block_size; ++i) {
+      if(tail[i] < lo) lo = tail[i];
+      if(hi < tail[i]) hi = tail[i];
+    }
+    word range = word(U(U(hi) - U(lo)));
+    unsigned width = 0;
+    while(width < 64 && (range >> width)) ++width;
+    // block_size values of width bits take exactly 2 * width words
+    size_t need = used + block_size * width / 64;
+    if(need + 1 > capacity) {
+      while(need + 1 > capacity) capacity = resize_func(capacity);
+      words = (word*) realloc(words, capacity * sizeof(word));
+    }
+    memset(words + used, 0, (need + 1 - used) * sizeof(word));
+    blocks.push_back(block{lo, used, width});
+    if(width) {
+      word* w = words + used;
+      for(size_t i = 0; i < block_size; ++i) {
+        word v = word(U(U(tail[i]) - U(lo)));
+        size_t bit = i * width;
+        size_t k = bit / 64;
+        unsigned s = bit % 64;
+        w[k] |= v << s;
+        if(s + width > 64) w[k + 1] |= v >> (64 - s);
+      }
+    }
+    used = need;
+  }
+};
+}
+
+#endif
@@ -0,0 +1,626 @@
+#ifndef SJTU_PERSISTENT_VECTOR_HPP
+#define SJTU_PERSISTENT_VECTOR_HPP
+
+/**
+ * Implemented as relaxed radix balanced tree (RRB-tree)
+ */
+
+#include "exceptions.hpp"
+
+#include <cstddef>
+#include <new>
+
+namespace sjtu
+{
+/**
+ * an immutable sequence, every modification returns a new version
+ * which shares all untouched nodes with the old one.
+ * push_back, set, concat and slice are O(logn), copying a version is O(1).
+ * Use transient to apply a batch of modifications in place.
+ * Versions may not be shared across threads, the reference counts are plain.
+ */
+template<typename T>
+class persistent_vector
+{
+public:
+  class transient;
+
+private:
+  static constexpr int bits = 5;
+  static constexpr int branch = 1 << bits;
+
+  class node {
+  public:
+    size_t refs;
+    int count;
+    node() : refs(1), count(0) {}
+  };
+  class leaf : public node {
+  public:
+    alignas(T) unsigned char buf[branch * sizeof(T)];
+    T* val() { return reinterpret_cast<T*>(buf); }
+  };
+  // sizes[i] is the number of elements in child[0..i]
+  class inner : public node {
+  public:
+    node* child[branch];
+    size_t sizes[branch];
+  };
+
+  node* root;
+  int height; // 0 if root is a leaf
+  size_t siz;
+
+public:
+  persistent_vector() : root(nullptr), height(0), siz(0) {}
+  persistent_vector(const persistent_vector &other)
+          : root(other.root), height(other.height), siz(other.siz) {
+    if(root) ++root->refs;
+  }
+  ~persistent_vector() {
+    if(root) release(root, height);
+  }
+  persistent_vector &operator=(const persistent_vector &other) {
+    if(this == &other) return *this;
+    if(other.root) ++other.root->refs;
+    if(root) release(root, height);
+    root = other.root, height = other.height, siz = other.siz;
+    return *this;
+  }
+
+  /**
+   * throw index_out_of_bound if pos is not in [0, size)
+   */
+  const T & at(const size_t &pos) const {
+    if(pos >= siz) throw index_out_of_bound();
+    size_t i = pos;
+    node* p = root;
+    for(int h = height; h > 0; --h) {
+      p = locate(static_cast<inner*>(p), h, i);
+    }
+    return static_cast<leaf*>(p)->val()[i];
+  }
+  const T & operator[](const size_t &pos) const {
+    return at(pos);
+  }
+  /**
+   * throw container_is_empty if size == 0
+   */
+  const T & front() const {
+    if(siz == 0) throw container_is_empty();
+    return at(0);
+  }
+  const T & back() const {
+    if(siz == 0) throw container_is_empty();
+    return at(siz - 1);
+  }
+  bool empty() const {
+    return siz == 0;
+  }
+  size_t size() const {
+    return siz;
+  }
+  // The number of levels above the leaves
+  int depth() const {
+    return height;
+  }
+  /**
+   * calls f(element) for every element in order.
+   */
+  template<class F>
+  void for_each(F f) const {
+    if(root) visit(root, height, f);
+  }
+
+  persistent_vector push_back(const T &value) const {
+    persistent_vector ret(*this);
+    ret.push_in_place(value);
+    return ret;
+  }
+  /**
+   * throw index_out_of_bound if pos is not in [0, size)
+   */
+  persistent_vector set(const size_t &pos, const T &value) const {
+    persistent_vector ret(*this);
+    ret.set_in_place(pos, value);
+    return ret;
+  }
+  /**
+   * remove the last element.
+   * throw container_is_empty if size == 0
+   */
+  persistent_vector pop_back() const {
+    if(siz == 0) throw container_is_empty();
+    return slice(0, siz - 1);
+  }
+  /**
+   * returns this followed by other.
+   */
+  persistent_vector concat(const persistent_vector &other) const {
+    if(other.siz == 0) return *this;
+    if(siz == 0) return other;
+    node* out[2];
+    int n = join(root, height, other.root, other.height, out);
+    persistent_vector ret;
+    ret.height = height > other.height ? height : other.height;
+    ret.siz = siz + other.siz;
+    if(n == 1) {
+      ret.root = out[0];
+    }
+    else {
+      ret.root = make_inner(out, 2, ret.height + 1);
+      ++ret.height;
+    }
+    return ret;
+  }
+  /**
+   * returns the elements in [from, to).
+   * throw index_out_of_bound if from > to or to > size
+   */
+  persistent_vector slice(const size_t &from, const size_t &to) const {
+    if(from > to || to > siz) throw index_out_of_bound();
+    persistent_vector ret;
+    if(from == to) return ret;
+    node* head = take(root, height, to);
+    try {
+      ret.root = drop(head, height, from);
+    }
+    catch(...) {
+      release(head, height);
+      throw;
+    }
+    release(head, height);
+    ret.height = height;
+    ret.siz = to - from;
+    // Collapse the single-child levels left by the cut
+    while(ret.height > 0 && ret.root->count == 1) {
+      node* c = static_cast<inner*>(ret.root)->child[0];
+      ++c->refs;
+      release(ret.root, ret.height);
+      ret.root = c;
+      --ret.height;
+    }
+    return ret;
+  }
+  /**
+   * a mutable handle for building or editing in bulk.
+   * Nodes owned only by the transient are modified in place,
+   * shared ones are copied on first touch.
+   */
+  transient as_transient() const {
+    return transient(*this);
+  }
+
+  class transient
+  {
+  private:
+    persistent_vector vec;
+
+  public:
+    transient() = default;
+    explicit transient(const persistent_vector &v) : vec(v) {}
+
+    const T & at(const size_t &pos) const {
+      return vec.at(pos);
+    }
+    const T & operator[](const size_t &pos) const {
+      return vec.at(pos);
+    }
+    bool empty() const {
+      return vec.empty();
+    }
+    size_t size() const {
+      return vec.size();
+    }
+    void push_back(const T &value) {
+      vec.push_in_place(value);
+    }
+    /**
+     * throw index_out_of_bound if pos is not in [0, size)
+     */
+    void set(const size_t &pos, const T &value) {
+      vec.set_in_place(pos, value);
+    }
+    /**
+     * a snapshot of the current content, later edits copy the shared nodes.
+     */
+    persistent_vector persistent() const {
+      return vec;
+    }
+  };
+
+private:
+  static size_t size_of(node* p, int h) {
+    if(h == 0) return p->count;
+    return static_cast<inner*>(p)->sizes[p->count - 1];
+  }
+  static void release(node* p, int h) {
+    if(--p->refs) return;
+    if(h == 0) {
+      leaf* l = static_cast<leaf*>(p);
+      for(int i = 0; i < l->count; ++i) {
+        l->val()[i].~T();
+      }
+      delete l;
+    }
+    else {
+      inner* in = static_cast<inner*>(p);
+      for(int i = 0; i < in->count; ++i) {
+        release(in->child[i], h - 1);
+      }
+      delete in;
+    }
+  }
+  /**
+   * find the child of p (at height h) holding element i, i becomes the index inside it.
+   * A child holds at most branch^h elements, so i >> (bits * h) never overshoots.
+   */
+  static node* locate(inner* p, int h, size_t &i, size_t &j) {
+    j = i >> (bits * h);
+    while(p->sizes[j] <= i) ++j;
+    if(j > 0) i -= p->sizes[j - 1];
+    return p->child[j];
+  }
+  static node* locate(inner* p, int h, size_t &i) {
+    size_t j;
+    return locate(p, h, i, j);
+  }
+  static void fix_sizes(inner* p, int h) {
+    size_t sum = 0;
+    for(int i = 0; i < p->count; ++i) {
+      sum += size_of(p->child[i], h - 1);
+      p->sizes[i] = sum;
+    }
+  }
+  // New leaf holding a[0..na) followed by b[0..nb)
+  static leaf* make_leaf(const T* a, int na, const T* b, int nb) {
+    leaf* l = new leaf;
+    try {
+      for(; l->count < na; ++l->count) {
+        new(l->val() + l->count) T(a[l->count]);
+      }
+      for(; l->count < na + nb; ++l->count) {
+        new(l->val() + l->count) T(b[l->count - na]);
+      }
+    }
+    catch(...) {
+      release(l, 0);
+      throw;
+    }
+    return l;
+  }
+  // New inner node at height h taking over the references in kids
+  static inner* make_inner(node** kids, int n, int h) {
+    inner* p;
+    try {
+      p = new inner;
+    }
+    catch(...) {
+      for(int i = 0; i < n; ++i) release(kids[i], h - 1);
+      throw;
+    }
+    for(int i = 0; i < n; ++i) p->child[i] = kids[i];
+    p->count = n;
+    fix_sizes(p, h);
+    return p;
+  }
+  // Spread at most 2 * branch kids over one or two nodes, left one full first
+  static int pack(node** kids, int n, int h, node* out[2]) {
+    if(n <= branch) {
+      out[0] = make_inner(kids, n, h);
+      return 1;
+    }
+    try {
+      out[0] = make_inner(kids, branch, h);
+    }
+    catch(...) {
+      for(int i = branch; i < n; ++i) release(kids[i], h - 1);
+      throw;
+    }
+    try {
+      out[1] = make_inner(kids + branch, n - branch, h);
+    }
+    catch(...) {
+      release(out[0], h);
+      throw;
+    }
+    return 2;
+  }
+  // Replace slot by a private copy unless it is the only reference
+  static void make_unique(node* &slot, int h) {
+    if(slot->refs == 1) return;
+    node* cp;
+    if(h == 0) {
+      leaf* l = static_cast<leaf*>(slot);
+      cp = make_leaf(l->val(), l->count, nullptr, 0);
+    }
+    else {
+      inner* in = static_cast<inner*>(slot);
+      inner* c = new inner;
+      for(int i = 0; i < in->count; ++i) {
+        c->child[i] = in->child[i];
+        c->sizes[i] = in->sizes[i];
+        ++c->child[i]->refs;
+      }
+      c->count = in->count;
+      cp = c;
+    }
+    --slot->refs;
+    slot = cp;
+  }
+
+  template<class F>
+  static void visit(node* p, int h, F &f) {
+    if(h == 0) {
+      leaf* l = static_cast<leaf*>(p);
+      for(int i = 0; i < l->count; ++i) f(l->val()[i]);
+      return;
+    }
+    inner* in = static_cast<inner*>(p);
+    for(int i = 0; i < in->count; ++i) visit(in->child[i], h - 1, f);
+  }
+
+  /**
+   * appends value under slot, returns a sibling of slot at height h
+   * if slot is full, nullptr otherwise.
+   * The content is unchanged if an exception is thrown.
+   */
+  static node* push(node* &slot, int h, const T &value) {
+    if(h == 0) {
+      if(slot->count == branch) return make_leaf(&value, 1, nullptr, 0);
+      make_unique(slot, 0);
+      leaf* l = static_cast<leaf*>(slot);
+      new(l->val() + l->count) T(value);
+      ++l->count;
+      return nullptr;
+    }
+    make_unique(slot, h);
+    inner* p = static_cast<inner*>(slot);
+    node* extra = push(p->child[p->count - 1], h - 1, value);
+    if(!extra) {
+      ++p->sizes[p->count - 1];
+      return nullptr;
+    }
+    if(p->count < branch) {
+      p->child[p->count] = extra;
+      p->sizes[p->count] = p->sizes[p->count - 1] + size_of(extra, h - 1);
+      ++p->count;
+      return nullptr;
+    }
+    return make_inner(&extra, 1, h);
+  }
+  void push_in_place(const T &value) {
+    if(!root) {
+      root = make_leaf(&value, 1, nullptr, 0);
+      height = 0, siz = 1;
+      return;
+    }
+    node* extra = push(root, height, value);
+    if(extra) {
+      inner* r;
+      try {
+        r = new inner;
+      }
+      catch(...) {
+        release(extra, height);
+        throw;
+      }
+      r->child[0] = root, r->child[1] = extra;
+      r->count = 2;
+      fix_sizes(r, height + 1);
+      root = r;
+      ++height;
+    }
+    ++siz;
+  }
+  static void assign(node* &slot, int h, size_t i, const T &value) {
+    make_unique(slot, h);
+    if(h == 0) {
+      static_cast<leaf*>(slot)->val()[i] = value;
+      return;
+    }
+    inner* p = static_cast<inner*>(slot);
+    size_t j = 0;
+    locate(p, h, i, j);
+    assign(p->child[j], h - 1, i, value);
+  }
+  void set_in_place(const size_t &pos, const T &value) {
+    if(pos >= siz) throw index_out_of_bound();
+    assign(root, height, pos, value);
+  }
+
+  /**
+   * joins the trees L (height hl) and R (height hr) into one or two nodes
+   * of height max(hl, hr), written to out. Boundary leaves are merged so
+   * that the left one is full, and the children gathered on every level
+   * are rebalanced before they are packed. L and R are left untouched.
+   */
+  static int join(node* L, int hl, node* R, int hr, node* out[2]) {
+    node* res[2];
+    node* kids[2 * branch];
+    int n = 0;
+    if(hl == 0 && hr == 0) {
+      leaf* l = static_cast<leaf*>(L);
+      leaf* r = static_cast<leaf*>(R);
+      if(l->count + r->count <= branch) {
+        out[0] = make_leaf(l->val(), l->count, r->val(), r->count);
+        return 1;
+      }
+      if(l->count == branch) {
+        ++L->refs, ++R->refs;
+        out[0] = L, out[1] = R;
+        return 2;
+      }
+      int moved = branch - l->count;
+      out[0] = make_leaf(l->val(), l->count, r->val(), moved);
+      try {
+        out[1] = make_leaf(r->val() + moved, r->count - moved, nullptr, 0);
+      }
+      catch(...) {
+        release(out[0], 0);
+        throw;
+      }
+      return 2;
+    }
+    int h = hl > hr ? hl : hr;
+    inner* l = static_cast<inner*>(L);
+    inner* r = static_cast<inner*>(R);
+    // Join the facing spines one level down, then regroup the children
+    int m;
+    if(hl > hr) m = join(l->child[l->count - 1], hl - 1, R, hr, res);
+    else if(hr > hl) m = join(L, hl, r->child[0], hr - 1, res);
+    else m = join(l->child[l->count - 1], hl - 1, r->child[0], hr - 1, res);
+    if(hl >= hr) {
+      for(int i = 0; i < l->count - 1; ++i) {
+        kids[n] = l->child[i];
+        ++kids[n++]->refs;
+      }
+    }
+    for(int i = 0; i < m; ++i) kids[n++] = res[i];
+    if(hr >= hl) {
+      for(int i = 1; i < r->count; ++i) {
+        kids[n] = r->child[i];
+        ++kids[n++]->refs;
+      }
+    }
+    n = rebalance(kids, n, h - 1);
+    return pack(kids, n, h, out);
+  }
+  /**
+   * the concatenation plan of RRB-trees: kids[0..n) are nodes of height h
+   * whose slots (elements or children) are shuffled into fewer nodes until
+   * n is at most extras above the minimum, ceil(slots / branch). A node
+   * with at most branch - 2 slots is emptied into the nodes after it.
+   * This keeps every level near full, so the height stays O(logn).
+   * Takes over the references in kids, returns the new n.
+   */
+  static int rebalance(node** kids, int n, int h) {
+    static constexpr int extras = 2;
+    int plan[2 * branch];
+    int total = 0;
+    for(int i = 0; i < n; ++i) {
+      plan[i] = kids[i]->count;
+      total += plan[i];
+    }
+    int len = n;
+    int optimal = (total + branch - 1) / branch;
+    for(int i = 0; len > optimal + extras; --i) {
+      while(plan[i] > branch - 2) ++i;
+      int rest = plan[i];
+      while(rest > 0) {
+        int fill = rest + plan[i + 1] < branch ? rest + plan[i + 1] : branch;
+        rest = rest + plan[i + 1] - fill;
+        plan[i++] = fill;
+      }
+      for(int j = i; j < len - 1; ++j) plan[j] = plan[j + 1];
+      --len;
+    }
+    if(len == n) return n;
+    node* fresh[2 * branch];
+    int k = 0, src = 0, off = 0; // the next slot to move is slot off of kids[src]
+    try {
+      for(; k < len; ++k) {
+        if(off == 0 && kids[src]->count == plan[k]) {
+          fresh[k] = kids[src++]; // untouched, keep it
+          continue;
+        }
+        fresh[k] = regroup(kids, src, off, plan[k], h);
+      }
+    }
+    catch(...) {
+      for(int i = 0; i < k; ++i) release(fresh[i], h);
+      for(int i = src; i < n; ++i) release(kids[i], h);
+      throw;
+    }
+    for(int i = 0; i < len; ++i) kids[i] = fresh[i];
+    return len;
+  }
+  /**
+   * new node of height h with the next want slots of kids, starting at
+   * slot off of kids[src]. Fully moved kids are released.
+   */
+  static node* regroup(node** kids, int &src, int &off, int want, int h) {
+    node* p;
+    if(h == 0) {
+      leaf* l = new leaf;
+      try {
+        while(l->count < want) {
+          leaf* from = static_cast<leaf*>(kids[src]);
+          new(l->val() + l->count) T(from->val()[off]);
+          ++l->count;
+          step(kids, src, off, h);
+        }
+      }
+      catch(...) {
+        release(l, 0);
+        throw;
+      }
+      p = l;
+    }
+    else {
+      inner* in = new inner;
+      while(in->count < want) {
+        node* c = static_cast<inner*>(kids[src])->child[off];
+        ++c->refs;
+        in->child[in->count++] = c;
+        step(kids, src, off, h);
+      }
+      fix_sizes(in, h);
+      p = in;
+    }
+    return p;
+  }
+  static void step(node** kids, int &src, int &off, int h) {
+    if(++off < kids[src]->count) return;
+    release(kids[src++], h);
+    off = 0;
+  }
+  // New node holding the first n (> 0) elements of p
+  static node* take(node* p, int h, size_t n) {
+    if(n == size_of(p, h)) {
+      ++p->refs;
+      return p;
+    }
+    if(h == 0) {
+      leaf* l = static_cast<leaf*>(p);
+      return make_leaf(l->val(), (int) n, nullptr, 0);
+    }
+    inner* in = static_cast<inner*>(p);
+    size_t i = n - 1;
+    int j = (int) (i >> (bits * h));
+    while(in->sizes[j] <= i) ++j;
+    size_t before = j > 0 ? in->sizes[j - 1] : 0;
+    node* kids[branch];
+    kids[j] = take(in->child[j], h - 1, n - before);
+    for(int k = 0; k < j; ++k) {
+      kids[k] = in->child[k];
+      ++kids[k]->refs;
+    }
+    return make_inner(kids, j + 1, h);
+  }
+  // New node holding the elements of p after the first n (< size)
+  static node* drop(node* p, int h, size_t n) {
+    if(n == 0) {
+      ++p->refs;
+      return p;
+    }
+    if(h == 0) {
+      leaf* l = static_cast<leaf*>(p);
+      return make_leaf(l->val() + n, l->count - (int) n, nullptr, 0);
+    }
+    inner* in = static_cast<inner*>(p);
+    int j = (int) (n >> (bits * h));
+    while(in->sizes[j] <= n) ++j;
+    size_t before = j > 0 ? in->sizes[j - 1] : 0;
+    node* kids[branch];
+    kids[0] = drop(in->child[j], h - 1, n - before);
+    for(int k = j + 1; k < in->count; ++k) {
+      kids[k - j] = in->child[k];
+      ++kids[k - j]->refs;
+    }
+    return make_inner(kids, in->count - j, h);
+  }
+};
+}
+
+#endif
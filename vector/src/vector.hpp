@@ -5,6 +5,14 @@
 
 #include <climits>
 #include <cstddef>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
 
 namespace sjtu
 {
@@ -13,6 +21,13 @@ namespace sjtu
  * store data in a successive memory and support random access.
  */
 auto resize_func = [] (size_t s) { return s / 2 * 3 + 1; };
+/**
+ * default key extractor of vector::radix_sort, the element is its own key.
+ */
+struct radix_identity {
+  template<class U>
+  const U & operator()(const U &x) const { return x; }
+};
 template<typename T>
 class vector
 {
@@ -35,9 +50,9 @@ public:
   public:
     using difference_type = std::ptrdiff_t;
     using value_type = T;
-    using pointer = T*;
-    using reference = T&;
-    using iterator_category = std::output_iterator_tag;
+    using pointer = const T*;
+    using reference = const T&;
+    using iterator_category = std::random_access_iterator_tag;
 
   private:
     vector* origin;
@@ -46,7 +61,7 @@ public:
     iterator(vector* _origin = nullptr, int _pos = 0)
             : origin (_origin), pos (_pos) {}
     ~iterator() = default;
-    iterator(iterator &other) {
+    iterator(const iterator &other) {
       origin = other.origin;
       pos = other.pos;
     }
@@ -64,7 +79,7 @@ public:
     }
     // return the distance between two iterators,
     // if these two iterators point to different vectors, throw invaild_iterator.
-    int operator-(const iterator &rhs) const 
+    difference_type operator-(const iterator &rhs) const 
     {
       if(origin != rhs.origin) throw invalid_iterator();
       else return pos - rhs.pos;
@@ -100,6 +115,15 @@ public:
     T& operator*() const{
       return origin->data[pos];
     }
+    T* operator->() const {
+      return origin->data + pos;
+    }
+    T& operator[](const int &n) const {
+      return origin->data[pos + n];
+    }
+    friend iterator operator+(const int &n, const iterator &it) {
+      return it + n;
+    }
     /**
      * a operator to check whether two iterators are same (pointing to the same memory address).
      */
@@ -118,6 +142,19 @@ public:
     bool operator!=(const const_iterator &rhs) const {
       return !(*this == rhs);
     }
+    // Ordering only makes sense inside one vector, as operator- does.
+    bool operator<(const iterator &rhs) const {
+      return *this - rhs < 0;
+    }
+    bool operator>(const iterator &rhs) const {
+      return rhs < *this;
+    }
+    bool operator<=(const iterator &rhs) const {
+      return !(rhs < *this);
+    }
+    bool operator>=(const iterator &rhs) const {
+      return !(*this < rhs);
+    }
   };
 
   class const_iterator 
@@ -129,7 +166,7 @@ public:
     using value_type = T;
     using pointer = T*;
     using reference = T&;
-    using iterator_category = std::output_iterator_tag;
+    using iterator_category = std::random_access_iterator_tag;
 
   private:
     const vector* origin;
@@ -151,7 +188,7 @@ public:
     {
       return const_iterator(origin, pos - n);
     }
-    int operator-(const const_iterator &rhs) const 
+    difference_type operator-(const const_iterator &rhs) const 
     {
       if(origin != rhs.origin) throw invalid_iterator();
       else return pos - rhs.pos;
@@ -187,6 +224,15 @@ public:
     const T& operator*() const {
       return origin->data[pos];
     }
+    const T* operator->() const {
+      return origin->data + pos;
+    }
+    const T& operator[](const int &n) const {
+      return origin->data[pos + n];
+    }
+    friend const_iterator operator+(const int &n, const const_iterator &it) {
+      return it + n;
+    }
     bool operator==(const const_iterator &rhs) const {
       return (origin == rhs.origin) && (pos == rhs.pos);
     }
@@ -199,16 +245,55 @@ public:
     bool operator!=(const iterator &rhs) const {
       return !(*this == rhs);
     }
+    bool operator<(const const_iterator &rhs) const {
+      return *this - rhs < 0;
+    }
+    bool operator>(const const_iterator &rhs) const {
+      return rhs < *this;
+    }
+    bool operator<=(const const_iterator &rhs) const {
+      return !(rhs < *this);
+    }
+    bool operator>=(const const_iterator &rhs) const {
+      return !(*this < rhs);
+    }
   };
 
   vector() : capacity(16), siz(0){
     data = (T*) malloc(capacity * sizeof(T));
   }
-  vector(const vector &other) : capacity(other.siz), siz(other.siz) {
+  vector(const vector &other) : vector(other, 1) {}
+  /**
+   * copy with the element range split across threads,
+   * each thread copies (and first touches) one contiguous chunk.
+   */
+  vector(const vector &other, unsigned threads) : siz(0), capacity(other.siz) {
     data = (T*) malloc(capacity * sizeof(T));
-    for(int i = 0; i < siz; ++i) {
-      new(data + i) T(other[i]); // Placement new
+    const T* src = other.data;
+    try {
+      construct(data, other.siz, threads, [src] (T* p, size_t i) {
+        new(p) T(src[i]); // Placement new
+      });
+    }
+    catch(...) {
+      free(data);
+      throw;
+    }
+    siz = other.siz;
+  }
+  /**
+   * constructs n copies of value, split across threads like the copy above.
+   */
+  vector(size_t n, const T &value, unsigned threads = 1) : siz(0), capacity(n ? n : 16) {
+    data = (T*) malloc(capacity * sizeof(T));
+    try {
+      construct(data, n, threads, [&value] (T* p, size_t) { new(p) T(value); });
+    }
+    catch(...) {
+      free(data);
+      throw;
     }
+    siz = n;
   }
 
   ~vector() {
@@ -232,6 +317,48 @@ public:
     }
     return *this;
   }
+  /**
+   * replaces the content with n copies of value.
+   * value may be an element of this vector, it is copied first.
+   */
+  void assign(size_t n, const T &value, unsigned threads = 1) {
+    T keep(value);
+    shrink(0);
+    if(capacity < n) {
+      free(data);
+      capacity = n;
+      data = (T*) malloc(capacity * sizeof(T));
+    }
+    construct(data, n, threads, [&keep] (T* p, size_t) { new(p) T(keep); });
+    siz = n;
+  }
+  /**
+   * assigns value to every element, split across threads.
+   */
+  void fill(const T &value, unsigned threads = 1) {
+    threads = clamp_threads(siz, threads);
+    if(threads == 1) {
+      for(size_t i = 0; i < siz; ++i) data[i] = value;
+      return;
+    }
+    T* d = data;
+    std::exception_ptr* err = new std::exception_ptr[threads];
+    auto work = [&] (unsigned t) {
+      try {
+        for(size_t i = chunk(siz, t, threads); i < chunk(siz, t + 1, threads); ++i) d[i] = value;
+      }
+      catch(...) {
+        err[t] = std::current_exception();
+      }
+    };
+    run_parallel(threads, work);
+    std::exception_ptr first = nullptr;
+    for(unsigned t = 0; t < threads; ++t) {
+      if(err[t] && !first) first = err[t];
+    }
+    delete[] err;
+    if(first) std::rethrow_exception(first);
+  }
   // Move the whole chunk to a bigger space
   void expand() {
     capacity = resize_func(capacity); // siz maintained
@@ -386,6 +513,408 @@ public:
     data[siz - 1].~T();
     --siz;
   }
+  /**
+   * removes every element satisfying pred in a single pass,
+   * each survivor is moved at most once.
+   * returns the number of removed elements.
+   */
+  template<class Pred>
+  size_t erase_if(Pred pred) {
+    size_t w = 0, r = 0;
+    try {
+      if constexpr (std::is_arithmetic_v<T>) {
+        // Branch-free: always write, only advance on keep, so an unpredictable
+        // pred costs no mispredicted branches. This is scalar code: the store
+        // index depends on the previous step, compilers do not vectorize it.
+        for(; r < siz; ++r) {
+          T cur = data[r];
+          data[w] = cur;
+          w += !pred(cur);
+        }
+      }
+      else {
+        for(; r < siz; ++r) {
+          if(pred(data[r])) continue;
+          if(w != r) data[w] = std::move(data[r]);
+          ++w;
+        }
+      }
+    }
+    catch(...) { // Keep unvisited elements lest pred failed
+      for(; r < siz; ++r, ++w) {
+        if(w != r) data[w] = std::move(data[r]);
+      }
+      shrink(w);
+      throw;
+    }
+    size_t removed = siz - w;
+    shrink(w);
+    return removed;
+  }
+  /**
+   * removes all but the first of every run of consecutive equal elements.
+   * returns the number of removed elements.
+   */
+  size_t unique() {
+    return unique([] (const T &a, const T &b) { return a == b; });
+  }
+  template<class BinaryPred>
+  size_t unique(BinaryPred eq) {
+    if(siz == 0) return 0;
+    size_t w = 0, r = 1;
+    try {
+      if constexpr (std::is_arithmetic_v<T>) {
+        // Slot w + 1 <= r is free, so writing it before the test is harmless.
+        // Branch-free like erase_if, and likewise not vectorized.
+        for(; r < siz; ++r) {
+          T cur = data[r];
+          data[w + 1] = cur;
+          w += !eq(data[w], cur);
+        }
+      }
+      else {
+        for(; r < siz; ++r) {
+          if(eq(data[w], data[r])) continue;
+          ++w;
+          if(w != r) data[w] = std::move(data[r]);
+        }
+      }
+    }
+    catch(...) {
+      for(; r < siz; ++r) {
+        ++w;
+        if(w != r) data[w] = std::move(data[r]);
+      }
+      shrink(w + 1);
+      throw;
+    }
+    size_t removed = siz - (w + 1);
+    shrink(w + 1);
+    return removed;
+  }
+  /**
+   * reorders the elements so that those satisfying pred precede the others,
+   * keeping the relative order inside both groups.
+   * Each call allocates a scratch buffer of size() elements. The accepted
+   * elements move at most once, the rejected ones twice: out to the
+   * buffer and back behind the accepted ones.
+   * returns an iterator to the first element of the second group.
+   */
+  template<class Pred>
+  iterator stable_partition(Pred pred) {
+    T* rest = (T*) malloc((siz ? siz : 1) * sizeof(T));
+    size_t w = 0, cnt = 0, r = 0;
+    try {
+      for(; r < siz; ++r) {
+        if(pred(data[r])) {
+          if(w != r) data[w] = std::move(data[r]);
+          ++w;
+        }
+        else {
+          new(rest + cnt) T(std::move(data[r]));
+          ++cnt;
+        }
+      }
+    }
+    catch(...) { // Put the rejected part back behind the unvisited part
+      for(; r < siz; ++r, ++w) {
+        if(w != r) data[w] = std::move(data[r]);
+      }
+      for(size_t i = 0; i < cnt; ++i, ++w) {
+        data[w] = std::move(rest[i]);
+        rest[i].~T();
+      }
+      free(rest);
+      throw;
+    }
+    for(size_t i = 0; i < cnt; ++i) {
+      data[w + i] = std::move(rest[i]);
+      rest[i].~T();
+    }
+    free(rest);
+    return iterator(this, w);
+  }
+
+  /**
+   * sorts with cmp in O(nlogn), not stable.
+   * introsort: quicksort with median-of-three pivots, heapsort once the
+   * recursion gets too deep, insertion sort for short ranges.
+   */
+  template<class Compare = std::less<T>>
+  void sort(Compare cmp = Compare()) {
+    if(siz < 2) return;
+    int depth = 0;
+    for(size_t n = siz; n > 1; n >>= 1) depth += 2;
+    intro_sort(data, data + siz, depth, cmp);
+  }
+  /**
+   * stable LSD radix sort on an integral key, 8 bits per pass.
+   * key(const T&) must return an integral type and must not throw;
+   * elements are moved between data and a scratch buffer of the same capacity.
+   * Passes in which every key has the same digit are skipped.
+   * With threads > 1 the counting and scattering of every pass are split
+   * into contiguous chunks, one per thread.
+   * Short vectors fall back to insertion sort on the key.
+   */
+  template<class Key = radix_identity>
+  void radix_sort(Key key = Key(), unsigned threads = 1) {
+    using K = std::decay_t<std::invoke_result_t<Key&, const T&>>;
+    static_assert(std::is_integral_v<K> && !std::is_same_v<K, bool>,
+                  "radix_sort needs an integral key");
+    using U = std::make_unsigned_t<K>;
+    if(siz < radix_cutoff) { // Insertion sort is stable as well
+      auto cmp = [&key] (const T &a, const T &b) { return key(a) < key(b); };
+      insertion_sort(data, data + siz, cmp);
+      return;
+    }
+    threads = clamp_threads(siz, threads);
+    auto ukey = [&key] (const T &x) -> U {
+      U k = static_cast<U>(key(x));
+      if constexpr (std::is_signed_v<K>) k ^= U(1) << (sizeof(U) * CHAR_BIT - 1);
+      return k;
+    };
+    // Bits in which some key differs from the first one
+    U* diff = (U*) malloc(threads * sizeof(U));
+    U base = ukey(data[0]);
+    auto scan = [&] (unsigned t) {
+      U d = 0;
+      for(size_t i = chunk(siz, t, threads); i < chunk(siz, t + 1, threads); ++i) {
+        d |= ukey(data[i]) ^ base;
+      }
+      diff[t] = d;
+    };
+    run_parallel(threads, scan);
+    U all = 0;
+    for(unsigned t = 0; t < threads; ++t) all |= diff[t];
+    free(diff);
+
+    size_t* cnt = (size_t*) malloc(threads * 256 * sizeof(size_t));
+    T* src = data;
+    T* dst = (T*) malloc(capacity * sizeof(T));
+    for(int shift = 0; shift < (int) sizeof(U) * CHAR_BIT; shift += 8) {
+      if(((all >> shift) & 255) == 0) continue;
+      auto count = [&] (unsigned t) {
+        size_t* c = cnt + t * 256;
+        for(int d = 0; d < 256; ++d) c[d] = 0;
+        for(size_t i = chunk(siz, t, threads); i < chunk(siz, t + 1, threads); ++i) {
+          ++c[(ukey(src[i]) >> shift) & 255];
+        }
+      };
+      run_parallel(threads, count);
+      // Turn the counts into start offsets, thread t after thread t - 1 in each bucket
+      size_t sum = 0;
+      for(int d = 0; d < 256; ++d) {
+        for(unsigned t = 0; t < threads; ++t) {
+          size_t c = cnt[t * 256 + d];
+          cnt[t * 256 + d] = sum;
+          sum += c;
+        }
+      }
+      auto scatter = [&] (unsigned t) {
+        size_t* off = cnt + t * 256;
+        for(size_t i = chunk(siz, t, threads); i < chunk(siz, t + 1, threads); ++i) {
+          new(dst + off[(ukey(src[i]) >> shift) & 255]++) T(std::move(src[i]));
+          src[i].~T();
+        }
+      };
+      run_parallel(threads, scatter);
+      T* tmp = src;
+      src = dst;
+      dst = tmp;
+    }
+    free(cnt);
+    free(dst); // holds no live elements at this point
+    data = src;
+  }
+
+private:
+  static constexpr size_t sort_cutoff = 16;
+  static constexpr size_t radix_cutoff = 256;
+  // Minimum number of elements worth handing to another thread
+  static constexpr size_t parallel_grain = 1 << 16;
+
+  // Start of the t-th of k contiguous chunks of [0, n)
+  static size_t chunk(size_t n, unsigned t, unsigned k) {
+    return n / k * t + (n % k) * t / k;
+  }
+  // Do not hand fewer than parallel_grain elements to a thread
+  static unsigned clamp_threads(size_t n, unsigned threads) {
+    if(threads > n / parallel_grain + 1) threads = n / parallel_grain + 1;
+    return threads ? threads : 1;
+  }
+  /**
+   * make(dst + i, i) placement-constructs element i for i in [0, n).
+   * Every thread constructs its own contiguous chunk, so the pages of the
+   * chunk are also first touched by that thread.
+   * If any construction throws, all constructed elements are destroyed
+   * and the first exception is rethrown.
+   */
+  template<class F>
+  static void construct(T* dst, size_t n, unsigned threads, F make) {
+    threads = clamp_threads(n, threads);
+    if(threads == 1) {
+      size_t i = 0;
+      try {
+        for(; i < n; ++i) make(dst + i, i);
+      }
+      catch(...) {
+        while(i > 0) dst[--i].~T();
+        throw;
+      }
+      return;
+    }
+    size_t* done = new size_t[threads];
+    std::exception_ptr* err = new std::exception_ptr[threads];
+    auto work = [&] (unsigned t) {
+      size_t i = chunk(n, t, threads), hi = chunk(n, t + 1, threads);
+      try {
+        for(; i < hi; ++i) make(dst + i, i);
+      }
+      catch(...) {
+        err[t] = std::current_exception();
+      }
+      done[t] = i;
+    };
+    run_parallel(threads, work);
+    std::exception_ptr first = nullptr;
+    for(unsigned t = 0; t < threads; ++t) {
+      if(err[t] && !first) first = err[t];
+    }
+    if(first) {
+      for(unsigned t = 0; t < threads; ++t) {
+        for(size_t i = chunk(n, t, threads); i < done[t]; ++i) dst[i].~T();
+      }
+    }
+    delete[] done;
+    delete[] err;
+    if(first) std::rethrow_exception(first);
+  }
+  /**
+   * run f(t) for t in [0, threads), t = 0 on the calling thread.
+   * If a thread cannot be started, its f(t) and the later ones run on the
+   * calling thread as well. The started threads are joined before anything
+   * is rethrown.
+   */
+  template<class F>
+  static void run_parallel(unsigned threads, F &f) {
+    if(threads <= 1) {
+      f(0u);
+      return;
+    }
+    std::thread* pool = new(std::nothrow) std::thread[threads - 1];
+    unsigned started = 0;
+    if(pool) {
+      try {
+        for(; started + 1 < threads; ++started) {
+          unsigned t = started + 1;
+          pool[started] = std::thread([&f, t] { f(t); });
+        }
+      }
+      catch(...) {} // std::system_error or bad_alloc, the rest runs here
+    }
+    try {
+      f(0u);
+      for(unsigned t = started + 1; t < threads; ++t) f(t);
+    }
+    catch(...) {
+      join_all(pool, started);
+      throw;
+    }
+    join_all(pool, started);
+  }
+  static void join_all(std::thread* pool, unsigned n) {
+    for(unsigned t = 0; t < n; ++t) pool[t].join();
+    delete[] pool;
+  }
+
+  template<class Compare>
+  static void intro_sort(T* first, T* last, int depth, Compare &cmp) {
+    while((size_t) (last - first) > sort_cutoff) {
+      if(depth == 0) {
+        heap_sort(first, last, cmp);
+        return;
+      }
+      --depth;
+      median_to_first(first, first + 1, first + (last - first) / 2, last - 1, cmp);
+      // Unguarded Hoare partition around *first
+      T* lo = first + 1;
+      T* hi = last;
+      while(true) {
+        while(cmp(*lo, *first)) ++lo;
+        --hi;
+        while(cmp(*first, *hi)) --hi;
+        if(!(lo < hi)) break;
+        std::swap(*lo, *hi);
+        ++lo;
+      }
+      // Recurse on the shorter side to bound the stack
+      if(lo - first < last - lo) {
+        intro_sort(first, lo, depth, cmp);
+        first = lo;
+      }
+      else {
+        intro_sort(lo, last, depth, cmp);
+        last = lo;
+      }
+    }
+    insertion_sort(first, last, cmp);
+  }
+  template<class Compare>
+  static void median_to_first(T* res, T* a, T* b, T* c, Compare &cmp) {
+    if(cmp(*a, *b)) {
+      if(cmp(*b, *c)) std::swap(*res, *b);
+      else if(cmp(*a, *c)) std::swap(*res, *c);
+      else std::swap(*res, *a);
+    }
+    else if(cmp(*a, *c)) std::swap(*res, *a);
+    else if(cmp(*b, *c)) std::swap(*res, *c);
+    else std::swap(*res, *b);
+  }
+  template<class Compare>
+  static void insertion_sort(T* first, T* last, Compare &cmp) {
+    if(first == last) return;
+    for(T* i = first + 1; i < last; ++i) {
+      if(!cmp(*i, *(i - 1))) continue;
+      T tmp = std::move(*i);
+      T* j = i;
+      do {
+        *j = std::move(*(j - 1));
+        --j;
+      } while(j > first && cmp(tmp, *(j - 1)));
+      *j = std::move(tmp);
+    }
+  }
+  template<class Compare>
+  static void sift_down(T* base, size_t i, size_t n, Compare &cmp) {
+    T tmp = std::move(base[i]);
+    while(true) {
+      size_t c = 2 * i + 1;
+      if(c >= n) break;
+      if(c + 1 < n && cmp(base[c], base[c + 1])) ++c;
+      if(!cmp(tmp, base[c])) break;
+      base[i] = std::move(base[c]);
+      i = c;
+    }
+    base[i] = std::move(tmp);
+  }
+  template<class Compare>
+  static void heap_sort(T* first, T* last, Compare &cmp) {
+    size_t n = last - first;
+    for(size_t i = n / 2; i-- > 0; ) {
+      sift_down(first, i, n, cmp);
+    }
+    for(size_t e = n - 1; e > 0; --e) {
+      std::swap(first[0], first[e]);
+      sift_down(first, 0, e, cmp);
+    }
+  }
+  // Destroy the elements in [n, siz)
+  void shrink(size_t n) {
+    for(size_t i = n; i < siz; ++i) {
+      data[i].~T();
+    }
+    siz = n;
+  }
 };
 }
 